@@ -0,0 +1,114 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * bench_allocator.cpp
+ *
+ */
+
+/*
+ *  STL node containers insert/erase throughput, std::allocator vs.
+ *  Objmempool_allocator.
+ *
+ *  Usage: bench_allocator [max_threads]
+ */
+
+#include "bench_common.h"
+#include "objmempool_allocator.h"
+
+#include <list>
+#include <map>
+#include <unordered_map>
+
+enum {KEYS = 1024, ROUNDS = 2000};
+
+template <typename MAP>
+static void map_churn(unsigned thread_idx, void * arg)
+{
+    UNUSED(thread_idx);
+    UNUSED(arg);
+    MAP map;
+    for(int round = 0; round < ROUNDS; ++round)
+    {
+        for(int key = 0; key < KEYS; ++key)
+            map.insert(typename MAP::value_type(key, key));
+        for(int key = 0; key < KEYS; ++key)
+            map.erase(key);
+    }
+}
+
+template <typename LIST>
+static void list_churn(unsigned thread_idx, void * arg)
+{
+    UNUSED(thread_idx);
+    UNUSED(arg);
+    LIST lst;
+    for(int round = 0; round < ROUNDS; ++round)
+    {
+        for(int key = 0; key < KEYS; ++key)
+            lst.push_back(key);
+        for(int key = 0; key < KEYS; ++key)
+            lst.pop_front();
+    }
+}
+
+static void run(const char * name, unsigned nthreads, bench_thread_func func)
+{
+    uint64_t elapsed = bench_run_threads(nthreads, func, NULL);
+    bench_report(name, nthreads, 2ULL * KEYS * ROUNDS * nthreads, elapsed);
+}
+
+int main(int argc, char ** argv)
+{
+    typedef std::pair<const int, int> Value;
+    typedef std::map<int, int> Map;
+    typedef std::map<int, int, std::less<int>, Objmempool_allocator<Value> > Pool_map;
+    typedef std::unordered_map<int, int> Hash_map;
+    typedef std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, Objmempool_allocator<Value> > Pool_hash_map;
+    typedef std::list<int> List;
+    typedef std::list<int, Objmempool_allocator<int> > Pool_list;
+
+    const unsigned max_threads = bench_arg_threads(argc, argv);
+
+    // Enough nodes for all threads, plus their caches.
+    uint32_t pool_size = (KEYS + 2 * Objmempool_allocator<int>::pool_type::CACHE_SIZE_DEFAULT) * max_threads;
+    Objmempool_allocator_base::set_pool_size(pool_size);
+
+    for(unsigned nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+    {
+        run("std::map<std::allocator>", nthreads, map_churn<Map>);
+        run("std::map<Objmempool_allocator>", nthreads, map_churn<Pool_map>);
+        run("std::unordered_map<std::allocator>", nthreads, map_churn<Hash_map>);
+        run("std::unordered_map<Objmempool_allocator>", nthreads, map_churn<Pool_hash_map>);
+        run("std::list<std::allocator>", nthreads, list_churn<List>);
+        run("std::list<Objmempool_allocator>", nthreads, list_churn<Pool_list>);
+    }
+
+    Objmempool_allocator_base::mempool_destroy_all();
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * bench_check.cpp
+ *
+ */
+
+/*
+ *  Checking mode (MEMPOOL_F_CHECKED) overhead on the cached alloc/free path,
+ *  for several free sample rates. The target is below 2% at the default rate.
+ *
+ *  Usage: bench_check [max_threads]
+ */
+
+#include "bench_common.h"
+#include "objmempool.h"
+
+enum {BATCH = 64, ROUNDS = 100000, REPEAT = 5, POOL_SIZE = 1 << 16};
+
+class Session : public Objmempool<Session>
+{
+public:
+    uint64_t id;
+    uint64_t data[7];
+};
+
+static void alloc_free(unsigned thread_idx, void * arg)
+{
+    UNUSED(arg);
+    Session * objs[BATCH];
+    Session::mempool_cache_create();
+    for(int round = 0; round < ROUNDS; ++round)
+    {
+        for(int i = 0; i < BATCH; ++i)
+        {
+            objs[i] = new Session;
+            objs[i]->id = thread_idx + i;
+        }
+        for(int i = 0; i < BATCH; ++i)
+            delete objs[i];
+    }
+    Session::mempool_cache_flush();
+    Session::mempool_cache_destroy();
+}
+
+// Best of REPEAT runs, the overhead is in the noise of a single run.
+static uint64_t run(const char * name, unsigned nthreads, unsigned int flags, unsigned int sample_rate)
+{
+    Session::mempool_create(POOL_SIZE, flags);
+    Session::mempool_check_set(sample_rate);
+    uint64_t elapsed = UINT64_MAX;
+    for(int i = 0; i < REPEAT; ++i)
+    {
+        uint64_t ns = bench_run_threads(nthreads, alloc_free, NULL);
+        if(ns < elapsed)
+            elapsed = ns;
+    }
+    bench_report(name, nthreads, (uint64_t)BATCH * ROUNDS * nthreads, elapsed);
+    Session::mempool_check_set();
+    Session::mempool_destroy();
+    return elapsed;
+}
+
+int main(int argc, char ** argv)
+{
+    const unsigned max_threads = bench_arg_threads(argc, argv);
+    static const unsigned int rates[] = {1024, Objmempool_check::SAMPLE_RATE_DEFAULT, 1};
+
+    for(unsigned nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+    {
+        uint64_t base = run("unchecked", nthreads, 0, Objmempool_check::SAMPLE_RATE_DEFAULT);
+        for(unsigned int i = 0; i < sizeof(rates) / sizeof(rates[0]); ++i)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "checked 1/%u", rates[i]);
+            uint64_t elapsed = run(name, nthreads, Session::MEMPOOL_F_CHECKED, rates[i]);
+            printf("  overhead: %.2f%%\n", 100.0 * ((double)elapsed - base) / base);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * bench_common.h
+ *
+ */
+
+#ifndef BENCH_COMMON_H_
+#define BENCH_COMMON_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/*
+ *  Minimal helpers shared by the benchmarks: a monotonic clock and a
+ *  barrier synchronized multi-thread runner.
+ */
+
+static inline uint64_t bench_now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+typedef void (*bench_thread_func)(unsigned thread_idx, void * arg);
+
+struct Bench_thread_ctx
+{
+    bench_thread_func func;
+    void * arg;
+    unsigned thread_idx;
+    pthread_barrier_t * barrier;
+};
+
+static inline void * bench_thread_entry(void * arg)
+{
+    Bench_thread_ctx * ctx = static_cast<Bench_thread_ctx *>(arg);
+    pthread_barrier_wait(ctx->barrier);
+    ctx->func(ctx->thread_idx, ctx->arg);
+    return NULL;
+}
+
+/*
+ *  Run func on nthreads threads, all released at once.
+ *  Returns the wall time (ns) from the release until the last thread ended.
+ */
+static inline uint64_t bench_run_threads(unsigned nthreads, bench_thread_func func, void * arg)
+{
+    pthread_t * threads = static_cast<pthread_t *>(malloc(nthreads * sizeof(pthread_t)));
+    Bench_thread_ctx * ctx = static_cast<Bench_thread_ctx *>(malloc(nthreads * sizeof(Bench_thread_ctx)));
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, nthreads + 1);
+
+    for(unsigned i = 0; i < nthreads; ++i)
+    {
+        ctx[i].func = func;
+        ctx[i].arg = arg;
+        ctx[i].thread_idx = i;
+        ctx[i].barrier = &barrier;
+        pthread_create(&threads[i], NULL, bench_thread_entry, &ctx[i]);
+    }
+
+    pthread_barrier_wait(&barrier);
+    uint64_t start = bench_now_ns();
+    for(unsigned i = 0; i < nthreads; ++i)
+        pthread_join(threads[i], NULL);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    pthread_barrier_destroy(&barrier);
+    free(ctx);
+    free(threads);
+    return elapsed;
+}
+
+static inline void bench_report(const char * name, unsigned nthreads, uint64_t ops, uint64_t elapsed_ns)
+{
+    printf("%-48s threads %3u  %10.2f Mops/s  %8.2f ns/op\n",
+           name, nthreads,
+           (double)ops * 1000.0 / (double)elapsed_ns,
+           (double)elapsed_ns * nthreads / (double)ops);
+}
+
+/*
+ *  Max thread count: first argument, or the number of online CPUs.
+ *  Note: The ring MP/MC operations spin on the other threads' progress, so
+ *  oversubscribing the CPUs measures the scheduler rather than the pool.
+ */
+static inline unsigned bench_arg_threads(int argc, char ** argv)
+{
+    if(argc > 1)
+        return (unsigned)atoi(argv[1]);
+    return (unsigned)sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+#endif /* BENCH_COMMON_H_ */
@@ -0,0 +1,147 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * bench_constructed.cpp
+ *
+ */
+
+/*
+ *  Objects with an expensive constructor (buffer allocation, mutex init,
+ *  zeroed table): new/delete from the pool vs. constructed mode
+ *  mempool_acquire/mempool_release.
+ *
+ *  Usage: bench_constructed [max_threads]
+ */
+
+#include "bench_common.h"
+#include "objmempool.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <vector>
+
+enum {BATCH = 64, ROUNDS = 20000, POOL_SIZE = 1 << 16};
+
+class Parser_state : public Objmempool<Parser_state>
+{
+public:
+    Parser_state() : buffer(), used(0)
+    {
+        buffer.reserve(4096);
+        pthread_mutex_init(&lock, NULL);
+        memset(offsets, 0, sizeof(offsets));
+    }
+
+    ~Parser_state()
+    {
+        pthread_mutex_destroy(&lock);
+    }
+
+    void mempool_obj_reset()
+    {
+        buffer.clear();
+        used = 0;
+    }
+
+    void parse(uint64_t token)
+    {
+        buffer.push_back(char(token));
+        offsets[used++ % 64] = (uint32_t)token;
+    }
+
+private:
+    std::vector<char> buffer;
+    pthread_mutex_t lock;
+    uint32_t offsets[64];
+    uint32_t used;
+};
+
+static void new_delete(unsigned thread_idx, void * arg)
+{
+    UNUSED(arg);
+    Parser_state * objs[BATCH];
+    Parser_state::mempool_cache_create();
+    for(int round = 0; round < ROUNDS; ++round)
+    {
+        for(int i = 0; i < BATCH; ++i)
+        {
+            objs[i] = new Parser_state;
+            objs[i]->parse(thread_idx + i);
+        }
+        for(int i = 0; i < BATCH; ++i)
+            delete objs[i];
+    }
+    Parser_state::mempool_cache_flush();
+    Parser_state::mempool_cache_destroy();
+}
+
+static void acquire_release(unsigned thread_idx, void * arg)
+{
+    UNUSED(arg);
+    Parser_state * objs[BATCH];
+    Parser_state::mempool_cache_create();
+    for(int round = 0; round < ROUNDS; ++round)
+    {
+        for(int i = 0; i < BATCH; ++i)
+        {
+            objs[i] = Parser_state::mempool_acquire();
+            objs[i]->parse(thread_idx + i);
+        }
+        for(int i = 0; i < BATCH; ++i)
+            Parser_state::mempool_release(objs[i]);
+    }
+    Parser_state::mempool_cache_flush();
+    Parser_state::mempool_cache_destroy();
+}
+
+static void run(const char * name, unsigned nthreads, bench_thread_func func)
+{
+    uint64_t elapsed = bench_run_threads(nthreads, func, NULL);
+    bench_report(name, nthreads, (uint64_t)BATCH * ROUNDS * nthreads, elapsed);
+}
+
+int main(int argc, char ** argv)
+{
+    const unsigned max_threads = bench_arg_threads(argc, argv);
+
+    for(unsigned nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+    {
+        Parser_state::mempool_create(POOL_SIZE);
+        run("new/delete", nthreads, new_delete);
+        Parser_state::mempool_destroy();
+
+        uint64_t start = bench_now_ns();
+        Parser_state::mempool_create(POOL_SIZE, Parser_state::MEMPOOL_F_CONSTRUCTED);
+        printf("constructed pool create: %.2f ms\n", (bench_now_ns() - start) / 1e6);
+        run("mempool_acquire/mempool_release", nthreads, acquire_release);
+        Parser_state::mempool_destroy();
+    }
+
+    return 0;
+}
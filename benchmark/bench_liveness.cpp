@@ -0,0 +1,139 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * bench_liveness.cpp
+ *
+ */
+
+/*
+ *  Sweep of all the live objects of a 10M objects pool, at several
+ *  occupancies: for_each_live (liveness bitmap) vs. walking an intrusive
+ *  list of the live objects, in allocation order and in a churned (random)
+ *  order.
+ *
+ *  Usage: bench_liveness [object_count]
+ */
+
+#include "bench_common.h"
+#include "objmempool.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+class Session : public Objmempool<Session>
+{
+public:
+    Session * next;
+    uint64_t deadline;
+    uint64_t data[6];
+};
+
+static uint64_t sweep_live()
+{
+    uint64_t sum = 0;
+    Session::for_each_live([&sum](Session * s) { sum += s->deadline; });
+    return sum;
+}
+
+static uint64_t sweep_list(const Session * head)
+{
+    uint64_t sum = 0;
+    for(const Session * s = head; s != NULL; s = s->next)
+        sum += s->deadline;
+    return sum;
+}
+
+static Session * link_list(const std::vector<Session*> & objs)
+{
+    Session * head = NULL;
+    for(size_t i = objs.size(); i-- > 0; )
+    {
+        objs[i]->next = head;
+        head = objs[i];
+    }
+    return head;
+}
+
+static void report(const char * name, unsigned occupancy, size_t live, uint64_t ns, uint64_t sum)
+{
+    printf("%-24s occupancy %3u%%  live %9zu  %8.2f ms  %6.2f ns/obj  (sum %llu)\n",
+           name, occupancy, live, ns / 1e6, live ? (double)ns / live : 0.0, (unsigned long long)sum);
+}
+
+int main(int argc, char ** argv)
+{
+    const size_t obj_count = (argc > 1) ? strtoull(argv[1], NULL, 0) : 10000000;
+    static const unsigned occupancies[] = {1, 10, 50, 90, 100};
+    std::mt19937_64 rng(1);
+
+    Session::mempool_create(obj_count + 1, Session::MEMPOOL_F_LIVENESS);
+
+    std::vector<Session*> objs(obj_count);
+    for(size_t i = 0; i < obj_count; ++i)
+    {
+        objs[i] = new Session;
+        objs[i]->deadline = i;
+    }
+
+    for(unsigned i = 0; i < sizeof(occupancies) / sizeof(occupancies[0]); ++i)
+    {
+        // Keep a random occupancy% subset of the objects.
+        std::shuffle(objs.begin(), objs.end(), rng);
+        std::vector<Session*> live(objs.begin(), objs.begin() + obj_count * occupancies[i] / 100);
+        for(size_t j = live.size(); j < obj_count; ++j)
+            delete objs[j];
+
+        uint64_t start = bench_now_ns();
+        uint64_t sum = sweep_live();
+        report("for_each_live", occupancies[i], live.size(), bench_now_ns() - start, sum);
+
+        std::sort(live.begin(), live.end());
+        Session * head = link_list(live);
+        start = bench_now_ns();
+        sum = sweep_list(head);
+        report("list, allocation order", occupancies[i], live.size(), bench_now_ns() - start, sum);
+
+        std::shuffle(live.begin(), live.end(), rng);
+        head = link_list(live);
+        start = bench_now_ns();
+        sum = sweep_list(head);
+        report("list, churned order", occupancies[i], live.size(), bench_now_ns() - start, sum);
+
+        // Back to a full pool.
+        for(size_t j = live.size(); j < obj_count; ++j)
+            objs[j] = new Session;
+    }
+
+    for(size_t i = 0; i < obj_count; ++i)
+        delete objs[i];
+    Session::mempool_destroy();
+
+    return 0;
+}
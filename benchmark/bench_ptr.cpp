@@ -0,0 +1,124 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * bench_ptr.cpp
+ *
+ */
+
+/*
+ *  Shared ownership churn: every thread creates objects, shares them (copies
+ *  the owning pointer) and drops them.
+ *  std::make_shared vs. allocate_pooled_shared and make_pooled_shared, and
+ *  std::make_unique vs. make_pooled.
+ *
+ *  Usage: bench_ptr [max_threads]
+ */
+
+#include "bench_common.h"
+#include "objmempool_ptr.h"
+
+#include <memory>
+#include <vector>
+
+enum {BATCH = 256, ROUNDS = 20000};
+
+struct Session
+{
+    Session(uint64_t id_) : id(id_), bytes(0), packets(0) {}
+
+    uint64_t id;
+    uint64_t bytes;
+    uint64_t packets;
+};
+
+template <typename PTR, PTR (*CREATE)(uint64_t)>
+static void shared_churn(unsigned thread_idx, void * arg)
+{
+    UNUSED(arg);
+    std::vector<PTR> owners(BATCH);
+    std::vector<PTR> sharers(BATCH);
+    for(int round = 0; round < ROUNDS; ++round)
+    {
+        for(int i = 0; i < BATCH; ++i)
+        {
+            owners[i] = CREATE(thread_idx + i);
+            sharers[i] = owners[i];
+        }
+        for(int i = 0; i < BATCH; ++i)
+        {
+            owners[i] = PTR();
+            sharers[i] = PTR();
+        }
+    }
+}
+
+static std::shared_ptr<Session> std_shared(uint64_t id) { return std::make_shared<Session>(id); }
+static std::shared_ptr<Session> pool_std_shared(uint64_t id) { return allocate_pooled_shared<Session>(id); }
+static Objmempool_shared_ptr<Session> pool_shared(uint64_t id) { return make_pooled_shared<Session>(id); }
+static std::unique_ptr<Session> std_unique(uint64_t id) { return std::unique_ptr<Session>(new Session(id)); }
+static Objmempool_unique_ptr<Session> pool_unique(uint64_t id) { return make_pooled<Session>(id); }
+
+template <typename PTR, PTR (*CREATE)(uint64_t)>
+static void unique_churn(unsigned thread_idx, void * arg)
+{
+    UNUSED(arg);
+    std::vector<PTR> owners(BATCH);
+    for(int round = 0; round < ROUNDS; ++round)
+    {
+        for(int i = 0; i < BATCH; ++i)
+            owners[i] = CREATE(thread_idx + i);
+        for(int i = 0; i < BATCH; ++i)
+            owners[i].reset();
+    }
+}
+
+static void run(const char * name, unsigned nthreads, bench_thread_func func)
+{
+    uint64_t elapsed = bench_run_threads(nthreads, func, NULL);
+    bench_report(name, nthreads, (uint64_t)BATCH * ROUNDS * nthreads, elapsed);
+}
+
+int main(int argc, char ** argv)
+{
+    const unsigned max_threads = bench_arg_threads(argc, argv);
+
+    Objmempool_allocator_base::set_pool_size((BATCH + 128) * max_threads);
+
+    for(unsigned nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+    {
+        run("std::make_shared", nthreads, shared_churn<std::shared_ptr<Session>, std_shared>);
+        run("allocate_pooled_shared", nthreads, shared_churn<std::shared_ptr<Session>, pool_std_shared>);
+        run("make_pooled_shared", nthreads, shared_churn<Objmempool_shared_ptr<Session>, pool_shared>);
+        run("std::unique_ptr(new)", nthreads, unique_churn<std::unique_ptr<Session>, std_unique>);
+        run("make_pooled", nthreads, unique_churn<Objmempool_unique_ptr<Session>, pool_unique>);
+    }
+
+    Objmempool_allocator_base::mempool_destroy_all();
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * bench_resource.cpp
+ *
+ */
+
+/*
+ *  pmr request parsing workload: a vector of strings of various lengths is
+ *  built and released, on a resource shared by all the threads.
+ *  Objmempool_memory_resource vs. the standard pmr resources.
+ *
+ *  Usage: bench_resource [max_threads]
+ */
+
+#include "bench_common.h"
+#include "objmempool_resource.h"
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+enum {FIELDS = 64, ROUNDS = 50000};
+
+struct Bench_ctx
+{
+    std::pmr::memory_resource * resource;
+    Objmempool_memory_resource * pool_resource;     // Set to create the thread caches.
+};
+
+static void parse_requests(unsigned thread_idx, void * arg)
+{
+    Bench_ctx * ctx = static_cast<Bench_ctx *>(arg);
+    if(ctx->pool_resource != NULL)
+        ctx->pool_resource->mempool_cache_create();
+
+    const char text[] = "GET /objmempool/some/reasonably/long/path/for/a/request/"
+                        "that/does/not/fit/in/the/small/string/buffer/"
+                        "Host: bench.local User-Agent: bench Accept: */* Connection: keep-alive";
+    unsigned seed = thread_idx;
+    for(int round = 0; round < ROUNDS; ++round)
+    {
+        std::pmr::vector<std::pmr::string> fields(ctx->resource);
+        for(int i = 0; i < FIELDS; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            std::size_t len = 16 + (seed >> 16) % (sizeof(text) - 16);
+            fields.emplace_back(text, len);
+        }
+    }
+
+    if(ctx->pool_resource != NULL)
+        ctx->pool_resource->mempool_cache_destroy();
+}
+
+static void run(const char * name, unsigned nthreads, Bench_ctx & ctx)
+{
+    uint64_t elapsed = bench_run_threads(nthreads, parse_requests, &ctx);
+    // Every round allocates FIELDS strings and ~log2(FIELDS) vector buffers.
+    bench_report(name, nthreads, (uint64_t)(FIELDS + 7) * ROUNDS * nthreads, elapsed);
+}
+
+int main(int argc, char ** argv)
+{
+    const unsigned max_threads = bench_arg_threads(argc, argv);
+
+    Objmempool_memory_resource::Options options;
+    options.obj_count = 1024 * max_threads;
+    Objmempool_memory_resource pool_resource(options);
+    std::pmr::synchronized_pool_resource sync_resource;
+
+    for(unsigned nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+    {
+        Bench_ctx new_delete_ctx = {std::pmr::new_delete_resource(), NULL};
+        run("pmr::new_delete_resource", nthreads, new_delete_ctx);
+
+        Bench_ctx sync_ctx = {&sync_resource, NULL};
+        run("pmr::synchronized_pool_resource", nthreads, sync_ctx);
+
+        Bench_ctx pool_ctx = {&pool_resource, &pool_resource};
+        run("Objmempool_memory_resource", nthreads, pool_ctx);
+
+        if(nthreads == 1)
+        {
+            std::pmr::unsynchronized_pool_resource unsync_resource;
+            Bench_ctx unsync_ctx = {&unsync_resource, NULL};
+            run("pmr::unsynchronized_pool_resource", nthreads, unsync_ctx);
+        }
+    }
+
+    return 0;
+}
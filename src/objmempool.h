@@ -42,8 +42,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "rte/rte_ring.h"
 #include "objmempool_container.h"
+#include "objmempool_check.h"
+#include "objmempool_bitmap.h"
+#include "objmempool_stats.h"
+#include <pthread.h>
 #include <typeinfo>
 #include <exception>
+#include <string>
+#include <new>
+#include <type_traits>
 
 #define POWEROF2(x) ((((x)-1) & (x)) == 0)
 
@@ -57,6 +64,18 @@ protected:
     Objmempool() {};
     ~Objmempool() {};
 
+    /*
+     *  Constructed mode hooks (see MEMPOOL_F_CONSTRUCTED), OBJ_TYPE may
+     *  redefine them (as public members).
+     *  - mempool_obj_construct: Runs once per slot, when the pool is created.
+     *  - mempool_obj_reset:     Runs on mempool_release, returns the object to
+     *                           its constructed state.
+     *  - mempool_obj_destroy:   Runs once per slot, when the pool is destroyed.
+     */
+    static void mempool_obj_construct(void * slot);
+    void mempool_obj_reset() {}
+    static void mempool_obj_destroy(OBJ_TYPE * obj) { obj->~OBJ_TYPE(); }
+
 public:
     static void * operator new (std::size_t size);
 
@@ -72,10 +91,27 @@ public:
      *
      *  The pool size must be a power of 2 and the user should consider that
      *  if the cache is used, the global pool size should be: global_pool_size + cache_size * num_of_threads
+     *
+     *  Flags:
+     *  - MEMPOOL_F_CONSTRUCTED: Slab constructor semantics, the slots are
+     *    constructed once at creation and keep their constructed state while
+     *    in the pool. Objects are taken with mempool_acquire and returned with
+     *    mempool_release (instead of new/delete), which only run the reset hook.
+     *  - MEMPOOL_F_CHECKED: Double free and use after free detection, see
+     *    mempool_check_set.
+     *  - MEMPOOL_F_LIVENESS: Slot liveness bitmap, see for_each_live.
+     *  - MEMPOOL_F_STATS: Publish the pool counters in a shared memory page,
+     *    see Objmempool_stats.
      */
-    static void mempool_create(std::size_t object_count);
+    enum {MEMPOOL_F_CONSTRUCTED = 0x0001, MEMPOOL_F_CHECKED = 0x0002, MEMPOOL_F_LIVENESS = 0x0004,
+          MEMPOOL_F_STATS = 0x0008};
+    static void mempool_create(std::size_t object_count, unsigned int flags = 0);
     static void mempool_destroy();
 
+    // Constructed mode object access.
+    static OBJ_TYPE * mempool_acquire();
+    static void mempool_release(OBJ_TYPE * obj);
+
     //Cache slots factor that are allocated above the requested cache size.
     enum {CACHE_SIZE_DEFAULT = 32, CACHE_BASE_FACTOR = 2};
     static void mempool_cache_create(std::size_t cache_size = CACHE_SIZE_DEFAULT);
@@ -84,6 +120,56 @@ public:
     static std::size_t get_mempool_free_obj_count();
     static std::size_t get_mempool_size();
 
+    /*
+     *  Raw slot access, for adapters that construct the object by themselves
+     *  (e.g. Objmempool_allocator).
+     *  mempool_alloc returns NULL when the pool is exhausted.
+     */
+    static void * mempool_alloc();
+    static void mempool_free(void * ptr);
+    static bool mempool_owns(const void * ptr);
+
+    // Return all the objects held by the thread cache to the pool.
+    static void mempool_cache_flush();
+
+    /*
+     *  Checking mode (MEMPOOL_F_CHECKED)
+     *  Frees into the thread cache are checked once every sample_rate frees
+     *  (a power of 2), frees without a cache are always checked.
+     *  A checked object is marked as freed, poisoned and held in a small per
+     *  thread quarantine: Freeing it again before it leaves the quarantine is
+     *  a double free, a broken poison pattern when it leaves is a use after
+     *  free (poisoning is skipped in constructed mode). Freeing an object that
+     *  is in the thread cache is detected as well.
+     *  The allocation path is not instrumented. mempool_cache_flush empties
+     *  the quarantine.
+     *  Errors are reported through the report callback and the offending free
+     *  is dropped, protecting the pool from corruption.
+     */
+    static void mempool_check_set(unsigned int sample_rate = Objmempool_check::SAMPLE_RATE_DEFAULT,
+                                  Objmempool_check::func_report report = Objmempool_check::report_default);
+    static std::size_t get_mempool_check_error_count();
+
+    /*
+     *  Liveness mode (MEMPOOL_F_LIVENESS)
+     *  A slot bit is set when the object leaves the free list ring and cleared
+     *  when it returns to it, i.e. the bitmap is updated in batches on cache
+     *  refill and flush and the cache fast path is untouched.
+     *  for_each_live copies the bitmap, removes the objects held by the thread
+     *  caches (and checking quarantines) and calls fn(OBJ_TYPE*) for each live
+     *  object, in address order.
+     *  Snapshot semantics: The sweep is exact for a pool that is quiesced or
+     *  used only by the sweeping thread. Objects allocated or freed by other
+     *  threads during the sweep may or may not be visited, and a visited
+     *  object may be freed concurrently by its owner: The caller synchronizes
+     *  object lifetime as it would for a shared list of the objects.
+     */
+    template <typename FUNC>
+    static void for_each_live(FUNC fn);
+
+    // Statistics page of a MEMPOOL_F_STATS pool, NULL otherwise.
+    static const Objmempool_stats::Page * get_mempool_stats_page();
+
     static int show_mempool_cmd(int argc, const char **argv, char *buf, std::size_t buf_size);
 
 private:
@@ -92,9 +178,40 @@ private:
 
     static rte_ring * new_free_list(std::string _name, unsigned int q_size, unsigned int type);
 
+    // Free list access, all the ring operations go through these.
+    static int ring_get_bulk(void ** objs, unsigned int n);
+    static unsigned int ring_get_burst(void ** objs, unsigned int n);
+    static void ring_put_bulk(void ** objs, unsigned int n);
+
+    static void free_obj(void * ptr);
+    static void check_free(void * ptr) __attribute__((noinline));
+    static void check_release(void * ptr);
+    static void check_quarantine_flush();
+    static bool check_slot(const void * ptr);
+    static void check_report(const void * obj, Objmempool_check::Error error);
+    static std::size_t slot_index(const void * ptr) { return static_cast<const obj_mem_slot*>(ptr) - obj_memory_head; }
+
+    static void live_set(void ** objs, unsigned int n);
+    static void live_clear(void ** objs, unsigned int n);
+
+    static void stats_update(long ring_delta, bool failed) __attribute__((noinline));
+
     static Free_list * free_list;
     static std::size_t obj_count;
     static obj_mem_slot * obj_memory_head;
+    static unsigned int pool_flags;
+    static Objmempool_bitmap live;
+    static Objmempool_stats::Page * stats_page;
+    static unsigned int stats_gen;      // Pool creations, invalidates the thread stats slots.
+
+    struct Check
+    {
+        Objmempool_bitmap freed;        // Slot is in a quarantine.
+        unsigned int sample_mask;
+        Objmempool_check::func_report report;
+        std::size_t errors;
+    };
+    static Check check;
 
     struct Cache
     {
@@ -102,8 +219,27 @@ private:
         std::size_t base_size;
         std::size_t len;                // Current cache length (may increase above base size)
         std::size_t flushthresh;        // Cache length for which anything above the base size is flushed to main pool.
+        unsigned int check_tick;        // Checking mode free sampling.
+        unsigned int quarantine_pos;
+        obj_mem_slot * quarantine[Objmempool_check::QUARANTINE_SIZE];
+        Cache * next;                   // Registered thread caches list.
+        Objmempool_stats::Thread_slot * stats;
+        unsigned int stats_gen;
     };
     static __thread Cache cache;		// NOTE: This is a TLS variable.
+
+    static Cache * cache_list;
+    static pthread_mutex_t cache_list_lock;
+    static void cache_register();
+    static void cache_unregister();
+    static void cache_exclude(const Cache * c, uint64_t * bitmap_words);
+
+    // Returns and destroys the thread cache on thread exit, keeping the registered list valid.
+    struct Cache_guard
+    {
+        ~Cache_guard() { mempool_cache_flush(); mempool_cache_destroy(); }
+    };
+    static thread_local Cache_guard cache_guard;
 	
 // Unsupported operators.
 private:
@@ -128,7 +264,32 @@ template <typename OBJ_TYPE>
 OBJ_TYPE * Objmempool<OBJ_TYPE>::obj_memory_head = NULL;
 
 template <typename OBJ_TYPE>
-__thread typename Objmempool<OBJ_TYPE>::Cache Objmempool<OBJ_TYPE>::cache = {NULL, 0, 0, 0};
+unsigned int Objmempool<OBJ_TYPE>::pool_flags = 0;
+
+template <typename OBJ_TYPE>
+typename Objmempool<OBJ_TYPE>::Check Objmempool<OBJ_TYPE>::check =
+    {Objmempool_bitmap(), Objmempool_check::SAMPLE_RATE_DEFAULT - 1, Objmempool_check::report_default, 0};
+
+template <typename OBJ_TYPE>
+__thread typename Objmempool<OBJ_TYPE>::Cache Objmempool<OBJ_TYPE>::cache = {NULL, 0, 0, 0, 0, 0, {NULL}, NULL, NULL, 0};
+
+template <typename OBJ_TYPE>
+Objmempool_stats::Page * Objmempool<OBJ_TYPE>::stats_page = NULL;
+
+template <typename OBJ_TYPE>
+unsigned int Objmempool<OBJ_TYPE>::stats_gen = 0;
+
+template <typename OBJ_TYPE>
+Objmempool_bitmap Objmempool<OBJ_TYPE>::live;
+
+template <typename OBJ_TYPE>
+typename Objmempool<OBJ_TYPE>::Cache * Objmempool<OBJ_TYPE>::cache_list = NULL;
+
+template <typename OBJ_TYPE>
+pthread_mutex_t Objmempool<OBJ_TYPE>::cache_list_lock = PTHREAD_MUTEX_INITIALIZER;
+
+template <typename OBJ_TYPE>
+thread_local typename Objmempool<OBJ_TYPE>::Cache_guard Objmempool<OBJ_TYPE>::cache_guard;
 
 
 template <typename OBJ_TYPE>
@@ -136,16 +297,47 @@ void * Objmempool<OBJ_TYPE>::operator new (std::size_t size)
 {
     UNUSED(size);
 
+    void * obj = mempool_alloc();
+    if(unlikely(obj == NULL))
+        throw -1; //abort();
+
+    return obj;
+}
+
+template <typename OBJ_TYPE>
+void* Objmempool<OBJ_TYPE>::operator new  ( std::size_t size, const std::nothrow_t& tag)
+{
+    UNUSED(size);
+    UNUSED(tag);
+    return mempool_alloc();
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::operator delete (void * ptr)
+{
+    mempool_free(ptr);
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::operator delete  ( void* ptr, const std::nothrow_t& tag )
+{
+    UNUSED(tag);
+    mempool_free(ptr);
+}
+
+template <typename OBJ_TYPE>
+void * Objmempool<OBJ_TYPE>::mempool_alloc()
+{
     if(cache.obj_memory_head != NULL)
     {
 
         if (cache.len < 1)
         {
             uint32_t req = cache.base_size - cache.len;
-            int ret = rte_ring_mc_dequeue_bulk(free_list, (void**)&cache.obj_memory_head[cache.len], req);
+            int ret = ring_get_bulk((void**)&cache.obj_memory_head[cache.len], req);
 
             if (unlikely(ret < 0))
-                throw -1; //abort();
+                return NULL;
 
             cache.len += req;
         }
@@ -158,9 +350,9 @@ void * Objmempool<OBJ_TYPE>::operator new (std::size_t size)
     {
         void * obj_array[1];
         const unsigned int num = 1;
-        unsigned int n = rte_ring_dequeue_burst(free_list, obj_array, num);
+        unsigned int n = ring_get_burst(obj_array, num);
         if(unlikely(n <= 0))
-            throw -1; //abort();
+            return NULL;
 
         void * obj = obj_array[0];
         return obj;
@@ -168,14 +360,20 @@ void * Objmempool<OBJ_TYPE>::operator new (std::size_t size)
 }
 
 template <typename OBJ_TYPE>
-void* Objmempool<OBJ_TYPE>::operator new  ( std::size_t size, const std::nothrow_t& tag)
+void Objmempool<OBJ_TYPE>::mempool_free(void * ptr)
 {
-    UNUSED(tag);
-    return operator new(size);
+    if(unlikely(pool_flags & MEMPOOL_F_CHECKED) &&
+       ((++cache.check_tick & check.sample_mask) == 0 || cache.obj_memory_head == NULL))
+    {
+        check_free(ptr);
+        return;
+    }
+
+    free_obj(ptr);
 }
 
 template <typename OBJ_TYPE>
-void Objmempool<OBJ_TYPE>::operator delete (void * ptr)
+inline void Objmempool<OBJ_TYPE>::free_obj(void * ptr)
 {
     if(cache.obj_memory_head != NULL)
     {
@@ -192,25 +390,24 @@ void Objmempool<OBJ_TYPE>::operator delete (void * ptr)
 
         if (cache.len >= cache.flushthresh)
         {
-            rte_ring_mp_enqueue_bulk(free_list, (void**)&cache.obj_memory_head[cache.base_size], cache.len - cache.base_size);
+            ring_put_bulk((void**)&cache.obj_memory_head[cache.base_size], cache.len - cache.base_size);
             cache.len = cache.base_size;
         }
     }
     else
     {
         const unsigned int num = 1;
-        unsigned int n = rte_ring_enqueue_burst(free_list, &ptr, num);
-        UNUSED(n);
+        ring_put_bulk(&ptr, num);
     }
 //    printf("\n" "cache.len[%zu], cache.flushthresh[%zu], cache.base_size[%zu], mempool_free_obj_count[%zu]",
 //            cache.len, cache.flushthresh, cache.base_size, get_mempool_free_obj_count());
 }
 
 template <typename OBJ_TYPE>
-void Objmempool<OBJ_TYPE>::operator delete  ( void* ptr, const std::nothrow_t& tag )
+bool Objmempool<OBJ_TYPE>::mempool_owns(const void * ptr)
 {
-    UNUSED(tag);
-    operator delete(ptr);
+    const obj_mem_slot * obj = static_cast<const obj_mem_slot*>(ptr);
+    return (obj >= obj_memory_head) && (obj < obj_memory_head + obj_count);
 }
 
 /*
@@ -218,12 +415,13 @@ void Objmempool<OBJ_TYPE>::operator delete  ( void* ptr, const std::nothrow_t& t
  *  Must be created at the application global init stage.
  */
 template <typename OBJ_TYPE>
-void Objmempool<OBJ_TYPE>::mempool_create(std::size_t object_count)
+void Objmempool<OBJ_TYPE>::mempool_create(std::size_t object_count, unsigned int flags)
 {
     if(NULL == free_list)
     {
     	free_list = new_free_list("noname", object_count, 0);
         obj_count = object_count-1;
+        pool_flags = flags;
 
         void * mem = malloc(obj_count * sizeof(obj_mem_slot));
         obj_memory_head = static_cast<obj_mem_slot*>(mem);
@@ -231,9 +429,26 @@ void Objmempool<OBJ_TYPE>::mempool_create(std::size_t object_count)
         for (size_t i=0; i < obj_count; ++i, ++obj)
         {
             void * const vobj = static_cast<void*>(obj);
+            if(pool_flags & MEMPOOL_F_CONSTRUCTED)
+                OBJ_TYPE::mempool_obj_construct(vobj);
             rte_ring_enqueue_burst(free_list, &vobj, 1);
         }
 
+        if(pool_flags & MEMPOOL_F_CHECKED)
+        {
+            check.freed.create(obj_count);
+            check.errors = 0;
+        }
+
+        if(pool_flags & MEMPOOL_F_LIVENESS)
+            live.create(obj_count);
+
+        if(pool_flags & MEMPOOL_F_STATS)
+        {
+            ++stats_gen;
+            stats_page = Objmempool_stats::create(typeid(OBJ_TYPE).name(), sizeof(obj_mem_slot), obj_count);
+        }
+
         Objmempool_container::add(static_cast<uint8_t*>(mem),
                                   sizeof(obj_mem_slot),
                                   obj_count,
@@ -244,10 +459,26 @@ void Objmempool<OBJ_TYPE>::mempool_create(std::size_t object_count)
 template <typename OBJ_TYPE>
 void Objmempool<OBJ_TYPE>::mempool_destroy()
 {
+    if(pool_flags & MEMPOOL_F_CONSTRUCTED)
+    {
+        for (size_t i=0; i < obj_count; ++i)
+            OBJ_TYPE::mempool_obj_destroy(&obj_memory_head[i]);
+    }
+
+    check.freed.destroy();
+    live.destroy();
+    Objmempool_stats::destroy(stats_page);
+    stats_page = NULL;
+    cache.stats = NULL;
+    cache.quarantine_pos = 0;
+    memset(cache.quarantine, 0, sizeof(cache.quarantine));
+
     free(free_list);
     free(obj_memory_head);
     obj_count = 0;
     free_list = NULL;
+    obj_memory_head = NULL;
+    pool_flags = 0;
 }
 
 /*
@@ -264,21 +495,68 @@ void Objmempool<OBJ_TYPE>::mempool_cache_create(std::size_t cache_size)
         cache.base_size = cache_size;
         cache.len = 0;
         cache.flushthresh = cache_size * CACHE_BASE_FACTOR;
+        cache_register();
     }
-
-    // TODO: For debug purposes the cache should be registered to a static list.
 }
 
 template <typename OBJ_TYPE>
 void Objmempool<OBJ_TYPE>::mempool_cache_destroy()
 {
     if(cache.obj_memory_head != NULL)
+    {
+        cache_unregister();
         free(cache.obj_memory_head);
+    }
 
     cache.obj_memory_head = NULL;
     cache.base_size = 0;
     cache.len = 0;
     cache.flushthresh = 0;
+    cache.check_tick = 0;
+}
+
+/*
+ *  Constructed mode: The object is handed out in its constructed (or reset)
+ *  state, no constructor runs. Returns NULL when the pool is exhausted.
+ */
+template <typename OBJ_TYPE>
+OBJ_TYPE * Objmempool<OBJ_TYPE>::mempool_acquire()
+{
+    return static_cast<OBJ_TYPE*>(mempool_alloc());
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::mempool_release(OBJ_TYPE * obj)
+{
+    obj->mempool_obj_reset();
+    mempool_free(obj);
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::mempool_obj_construct(void * slot)
+{
+    if constexpr (std::is_default_constructible<OBJ_TYPE>::value)
+        ::new (slot) OBJ_TYPE();
+    else
+        throw -1; //abort(); A construct hook is required for types without a default constructor.
+}
+
+/*
+ *  Return the thread cached objects to the pool, e.g. before a thread that
+ *  created a cache exits or when the pool is about to be inspected.
+ */
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::mempool_cache_flush()
+{
+    if(pool_flags & MEMPOOL_F_CHECKED)
+        check_quarantine_flush();
+
+    if(cache.obj_memory_head != NULL && cache.len > 0)
+    {
+        if(free_list != NULL)
+            ring_put_bulk((void**)cache.obj_memory_head, cache.len);
+        cache.len = 0;
+    }
 }
 
 template <typename OBJ_TYPE>
@@ -309,6 +587,11 @@ int Objmempool<OBJ_TYPE>::show_mempool_cmd(int argc, const char **argv, char *bu
                           get_mempool_free_obj_count(),
                           get_mempool_size(),
                           100 - 100 * get_mempool_free_obj_count() / get_mempool_size());
+    // snprintf returns the untruncated length.
+    if(ch_num < 0)
+        ch_num = 0;
+    else if((std::size_t)ch_num >= buf_size)
+        ch_num = (buf_size > 0) ? buf_size - 1 : 0;
     buf += ch_num;
     buf_size -= ch_num;
 
@@ -316,8 +599,252 @@ int Objmempool<OBJ_TYPE>::show_mempool_cmd(int argc, const char **argv, char *bu
 }
 
 
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::mempool_check_set(unsigned int sample_rate, Objmempool_check::func_report report)
+{
+    if(! POWEROF2(sample_rate))
+        round_up_to_a_powerof2(sample_rate);
+
+    check.sample_mask = sample_rate - 1;
+    check.report = (report != NULL) ? report : Objmempool_check::report_default;
+}
+
+template <typename OBJ_TYPE>
+std::size_t Objmempool<OBJ_TYPE>::get_mempool_check_error_count()
+{
+    return __atomic_load_n(&check.errors, __ATOMIC_RELAXED);
+}
+
+
 // Private implementations
 
+template <typename OBJ_TYPE>
+int Objmempool<OBJ_TYPE>::ring_get_bulk(void ** objs, unsigned int n)
+{
+    int ret = rte_ring_mc_dequeue_bulk(free_list, objs, n);
+    if(unlikely(pool_flags & MEMPOOL_F_LIVENESS) && ret == 0)
+        live_set(objs, n);
+    if(unlikely(stats_page != NULL))
+        stats_update((ret == 0) ? n : 0, ret != 0);
+    return ret;
+}
+
+template <typename OBJ_TYPE>
+unsigned int Objmempool<OBJ_TYPE>::ring_get_burst(void ** objs, unsigned int n)
+{
+    n = rte_ring_mc_dequeue_burst(free_list, objs, n);
+    if(unlikely(pool_flags & MEMPOOL_F_LIVENESS))
+        live_set(objs, n);
+    if(unlikely(stats_page != NULL))
+        stats_update(n, n == 0);
+    return n;
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::ring_put_bulk(void ** objs, unsigned int n)
+{
+    // Cleared before the enqueue, the objects may be dequeued right after it.
+    if(unlikely(pool_flags & MEMPOOL_F_LIVENESS))
+        live_clear(objs, n);
+    if(unlikely(stats_page != NULL))
+        stats_update(-(long)n, false);
+    rte_ring_mp_enqueue_bulk(free_list, objs, n);
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::live_set(void ** objs, unsigned int n)
+{
+    for(unsigned int i = 0; i < n; ++i)
+        live.set_atomic(slot_index(objs[i]));
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::live_clear(void ** objs, unsigned int n)
+{
+    for(unsigned int i = 0; i < n; ++i)
+        live.clear_atomic(slot_index(objs[i]));
+}
+
+/*
+ *  Publish a ring operation of this thread, the thread cache length is the
+ *  one after the operation completes.
+ */
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::stats_update(long ring_delta, bool failed)
+{
+    Objmempool_stats::Thread_slot * slot = cache.stats;
+    if(unlikely(slot == NULL || cache.stats_gen != stats_gen))
+    {
+        slot = cache.stats = Objmempool_stats::thread_slot_claim(stats_page);
+        cache.stats_gen = stats_gen;
+    }
+
+    Objmempool_stats::slot_update_begin(slot);
+    if(failed)
+        Objmempool_stats::slot_store(&slot->alloc_failures, slot->alloc_failures + 1);
+    else if(ring_delta > 0)
+        Objmempool_stats::slot_store(&slot->refills, slot->refills + 1);
+    else
+        Objmempool_stats::slot_store(&slot->flushes, slot->flushes + 1);
+    Objmempool_stats::slot_store(&slot->ring_out, slot->ring_out + ring_delta);
+    Objmempool_stats::slot_store(&slot->cached, (uint64_t)((cache.obj_memory_head != NULL) ? cache.len + ring_delta : 0));
+    Objmempool_stats::slot_update_end(slot);
+}
+
+template <typename OBJ_TYPE>
+const Objmempool_stats::Page * Objmempool<OBJ_TYPE>::get_mempool_stats_page()
+{
+    return stats_page;
+}
+
+template <typename OBJ_TYPE>
+template <typename FUNC>
+void Objmempool<OBJ_TYPE>::for_each_live(FUNC fn)
+{
+    if(! live.is_created())
+        return;
+
+    const std::size_t word_count = live.word_count();
+    uint64_t * snapshot = static_cast<uint64_t*>(malloc(word_count * sizeof(uint64_t)));
+    live.copy_to(snapshot);
+
+    pthread_mutex_lock(&cache_list_lock);
+    for(const Cache * c = cache_list; c != NULL; c = c->next)
+        cache_exclude(c, snapshot);
+    pthread_mutex_unlock(&cache_list_lock);
+
+    Objmempool_bitmap::for_each_set(snapshot, word_count,
+                                    [&fn](std::size_t idx) { fn(&obj_memory_head[idx]); });
+    free(snapshot);
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::cache_register()
+{
+    (void)&cache_guard;
+
+    pthread_mutex_lock(&cache_list_lock);
+    cache.next = cache_list;
+    cache_list = &cache;
+    pthread_mutex_unlock(&cache_list_lock);
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::cache_unregister()
+{
+    pthread_mutex_lock(&cache_list_lock);
+    for(Cache ** c = &cache_list; *c != NULL; c = &(*c)->next)
+    {
+        if(*c == &cache)
+        {
+            *c = cache.next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&cache_list_lock);
+    cache.next = NULL;
+}
+
+/*
+ *  Clear the bits of the objects held by a (possibly remote) thread cache.
+ *  The remote cache is read while its owner runs, the reads are bounded and
+ *  validated, the result is approximate for that thread.
+ */
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::cache_exclude(const Cache * c, uint64_t * bitmap_words)
+{
+    std::size_t len = __atomic_load_n(&c->len, __ATOMIC_RELAXED);
+    if(len > c->flushthresh)
+        len = c->flushthresh;
+
+    for(std::size_t i = 0; i < len + Objmempool_check::QUARANTINE_SIZE; ++i)
+    {
+        const obj_mem_slot * obj = (i < len) ? __atomic_load_n(&c->obj_memory_head[i], __ATOMIC_RELAXED)
+                                             : __atomic_load_n(&c->quarantine[i - len], __ATOMIC_RELAXED);
+        if(obj == NULL || ! mempool_owns(obj))
+            continue;
+
+        const std::size_t idx = slot_index(obj);
+        bitmap_words[idx / 64] &= ~(1ULL << (idx % 64));
+    }
+}
+
+/*
+ *  Check of a freed object, the offending free is dropped.
+ *  The object is quarantined, the oldest quarantined object is released.
+ */
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::check_free(void * ptr)
+{
+    if(! check_slot(ptr))
+    {
+        check_report(ptr, Objmempool_check::INVALID_PTR);
+        return;
+    }
+
+    const std::size_t idx = slot_index(ptr);
+    bool double_free = check.freed.set_atomic(idx);
+    for(std::size_t i = 0; i < cache.len && ! double_free; ++i)
+    {
+        if(cache.obj_memory_head[i] == ptr)
+        {
+            check.freed.clear_atomic(idx);
+            double_free = true;
+        }
+    }
+
+    if(double_free)
+    {
+        check_report(ptr, Objmempool_check::DOUBLE_FREE);
+        return;
+    }
+
+    if(! (pool_flags & MEMPOOL_F_CONSTRUCTED))
+        Objmempool_check::poison(ptr, sizeof(obj_mem_slot));
+
+    obj_mem_slot * oldest = cache.quarantine[cache.quarantine_pos];
+    cache.quarantine[cache.quarantine_pos] = static_cast<obj_mem_slot*>(ptr);
+    cache.quarantine_pos = (cache.quarantine_pos + 1) % Objmempool_check::QUARANTINE_SIZE;
+    if(oldest != NULL)
+        check_release(oldest);
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::check_release(void * ptr)
+{
+    if(! (pool_flags & MEMPOOL_F_CONSTRUCTED) && ! Objmempool_check::is_poisoned(ptr, sizeof(obj_mem_slot)))
+        check_report(ptr, Objmempool_check::USE_AFTER_FREE);
+
+    check.freed.clear_atomic(slot_index(ptr));
+    free_obj(ptr);
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::check_quarantine_flush()
+{
+    for(unsigned int i = 0; i < Objmempool_check::QUARANTINE_SIZE; ++i)
+    {
+        if(cache.quarantine[i] != NULL)
+            check_release(cache.quarantine[i]);
+        cache.quarantine[i] = NULL;
+    }
+    cache.quarantine_pos = 0;
+}
+
+template <typename OBJ_TYPE>
+bool Objmempool<OBJ_TYPE>::check_slot(const void * ptr)
+{
+    return mempool_owns(ptr) &&
+           ((static_cast<const uint8_t*>(ptr) - reinterpret_cast<const uint8_t*>(obj_memory_head)) % sizeof(obj_mem_slot)) == 0;
+}
+
+template <typename OBJ_TYPE>
+void Objmempool<OBJ_TYPE>::check_report(const void * obj, Objmempool_check::Error error)
+{
+    __atomic_fetch_add(&check.errors, 1, __ATOMIC_RELAXED);
+    check.report(typeid(OBJ_TYPE).name(), obj, error);
+}
+
 template <typename OBJ_TYPE>
 void Objmempool<OBJ_TYPE>::round_up_to_a_powerof2(uint32_t & size)
 {
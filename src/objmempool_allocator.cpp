@@ -0,0 +1,99 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * objmempool_allocator.cpp
+ *
+ */
+
+#include "objmempool_allocator.h"
+#include <pthread.h>
+#include <algorithm>
+#include <vector>
+
+std::size_t Objmempool_allocator_base::pool_size = Objmempool_allocator_base::POOL_SIZE_DEFAULT;
+
+__thread Objmempool_allocator_base::Thread_cache * Objmempool_allocator_base::thread_caches = NULL;
+
+static pthread_mutex_t pools_lock = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<void (*)()> pools_destroy;
+
+void Objmempool_allocator_base::set_pool_size(std::size_t object_count)
+{
+    pool_size = object_count;
+}
+
+std::size_t Objmempool_allocator_base::get_pool_size()
+{
+    return pool_size;
+}
+
+void Objmempool_allocator_base::mempool_destroy_all()
+{
+    mempool_cache_destroy_all();
+
+    pthread_mutex_lock(&pools_lock);
+    for(size_t i = 0; i < pools_destroy.size(); ++i)
+        pools_destroy[i]();
+    pools_destroy.clear();
+    pthread_mutex_unlock(&pools_lock);
+}
+
+void Objmempool_allocator_base::mempool_cache_destroy_all()
+{
+    while(thread_caches != NULL)
+    {
+        Thread_cache * tcache = thread_caches;
+        thread_caches = tcache->next;
+
+        func_pool_op destroy = tcache->destroy;
+        tcache->destroy = NULL;
+        tcache->next = NULL;
+        destroy();
+    }
+}
+
+/*
+ *  Node pools are created on demand, from any thread.
+ *  The create callback is expected to do nothing when the pool already exists.
+ */
+void Objmempool_allocator_base::pool_create(func_pool_op create, func_pool_op destroy)
+{
+    pthread_mutex_lock(&pools_lock);
+    create();
+    if(std::find(pools_destroy.begin(), pools_destroy.end(), destroy) == pools_destroy.end())
+        pools_destroy.push_back(destroy);
+    pthread_mutex_unlock(&pools_lock);
+}
+
+void Objmempool_allocator_base::cache_register(Thread_cache & tcache, func_pool_op destroy)
+{
+    tcache.destroy = destroy;
+    tcache.next = thread_caches;
+    thread_caches = &tcache;
+}
@@ -0,0 +1,195 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * objmempool_allocator.h
+ *
+ */
+
+#ifndef OBJMEMPOOL_ALLOCATOR_H_
+#define OBJMEMPOOL_ALLOCATOR_H_
+
+#include "objmempool.h"
+#include <new>
+#include <cstddef>
+#include <type_traits>
+
+/*
+ *  STL allocator adapter.
+ *
+ *  Single object allocations (the node allocations of std::list, std::map,
+ *  std::unordered_map, ...) are served from an Objmempool created for the
+ *  rebound (node) type, with a per-thread cache.
+ *  Multi object allocations (e.g. the unordered_map bucket array) and
+ *  allocations above the pool capacity fall back to the heap.
+ *
+ *  The node pools are created on the first single object allocation of each
+ *  rebound type, with Objmempool_allocator_base::get_pool_size() objects.
+ *  The thread caches are created on the first allocation from a thread and
+ *  are flushed back to the pool when the thread exits.
+ */
+class Objmempool_allocator_base
+{
+public:
+    enum {POOL_SIZE_DEFAULT = 4096};
+
+    // Node pool size, applies to node pools created after the call.
+    static void set_pool_size(std::size_t object_count);
+    static std::size_t get_pool_size();
+
+    /*
+     *  Destroy all the node pools (application exit stage).
+     *  The caches of the calling thread are destroyed as well, the caches of
+     *  all other threads must have been destroyed beforehand.
+     */
+    static void mempool_destroy_all();
+
+    // Flush and destroy the node pool caches of the calling thread.
+    static void mempool_cache_destroy_all();
+
+protected:
+    typedef void (*func_pool_op)();
+
+    struct Thread_cache
+    {
+        Thread_cache() : destroy(NULL), next(NULL) {}
+        ~Thread_cache() { if(destroy != NULL) destroy(); }
+
+        func_pool_op destroy;       // Set while the cache is active.
+        Thread_cache * next;
+    };
+
+    static void pool_create(func_pool_op create, func_pool_op destroy);
+    static void cache_register(Thread_cache & tcache, func_pool_op destroy);
+
+private:
+    static std::size_t pool_size;
+    static __thread Thread_cache * thread_caches;    // NOTE: This is a TLS variable.
+};
+
+template <typename T>
+class Objmempool_allocator_slot : public Objmempool<Objmempool_allocator_slot<T> >
+{
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+};
+
+template <typename T>
+class Objmempool_allocator : public Objmempool_allocator_base
+{
+public:
+    typedef T value_type;
+    typedef T * pointer;
+    typedef const T * const_pointer;
+    typedef T & reference;
+    typedef const T & const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind { typedef Objmempool_allocator<U> other; };
+
+    typedef Objmempool_allocator_slot<T> pool_type;
+
+    Objmempool_allocator() {}
+    template <typename U>
+    Objmempool_allocator(const Objmempool_allocator<U> & other) { UNUSED(other); }
+
+    T * allocate(std::size_t n);
+    void deallocate(T * ptr, std::size_t n);
+
+private:
+    static void thread_init();
+    static void pool_init();
+    static void cache_destroy();
+
+    static thread_local Thread_cache thread_cache;
+};
+
+template <typename T, typename U>
+inline bool operator==(const Objmempool_allocator<T> &, const Objmempool_allocator<U> &) { return true; }
+
+template <typename T, typename U>
+inline bool operator!=(const Objmempool_allocator<T> &, const Objmempool_allocator<U> &) { return false; }
+
+
+/*****************************
+ ** Implementation details  **
+ *****************************/
+
+template <typename T>
+thread_local typename Objmempool_allocator<T>::Thread_cache Objmempool_allocator<T>::thread_cache;
+
+template <typename T>
+T * Objmempool_allocator<T>::allocate(std::size_t n)
+{
+    if(likely(n == 1))
+    {
+        if(unlikely(thread_cache.destroy == NULL))
+            thread_init();
+
+        void * obj = pool_type::mempool_alloc();
+        if(likely(obj != NULL))
+            return static_cast<T*>(obj);
+    }
+
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+}
+
+template <typename T>
+void Objmempool_allocator<T>::deallocate(T * ptr, std::size_t n)
+{
+    if(likely(n == 1) && pool_type::mempool_owns(ptr))
+        pool_type::mempool_free(ptr);
+    else
+        ::operator delete(ptr);
+}
+
+template <typename T>
+void Objmempool_allocator<T>::thread_init()
+{
+    pool_create(pool_init, pool_type::mempool_destroy);
+
+    pool_type::mempool_cache_create();
+    cache_register(thread_cache, cache_destroy);
+}
+
+template <typename T>
+void Objmempool_allocator<T>::pool_init()
+{
+    if(pool_type::get_mempool_size() == 0)
+        pool_type::mempool_create(get_pool_size());
+}
+
+template <typename T>
+void Objmempool_allocator<T>::cache_destroy()
+{
+    pool_type::mempool_cache_flush();
+    pool_type::mempool_cache_destroy();
+}
+
+#endif /* OBJMEMPOOL_ALLOCATOR_H_ */
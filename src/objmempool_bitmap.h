@@ -0,0 +1,150 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * objmempool_bitmap.h
+ *
+ */
+
+#ifndef OBJMEMPOOL_BITMAP_H_
+#define OBJMEMPOOL_BITMAP_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cstddef>
+
+/*
+ *  Slot state bitmap, one bit per pool slot.
+ *  Concurrent threads update bits of the same word, hence the atomic
+ *  operations (relaxed, the bits carry no ordering).
+ */
+class Objmempool_bitmap
+{
+public:
+    constexpr Objmempool_bitmap() : words(NULL), nbits(0) {}
+
+    void create(std::size_t bits)
+    {
+        nbits = bits;
+        words = static_cast<uint64_t*>(calloc(word_count(), sizeof(uint64_t)));
+    }
+
+    void destroy()
+    {
+        free(words);
+        words = NULL;
+        nbits = 0;
+    }
+
+    void set_all()
+    {
+        memset(words, 0xff, word_count() * sizeof(uint64_t));
+        if(nbits % 64)
+            words[nbits / 64] = (1ULL << (nbits % 64)) - 1;
+    }
+
+    bool test(std::size_t bit) const
+    {
+        return (__atomic_load_n(&words[bit / 64], __ATOMIC_RELAXED) >> (bit % 64)) & 1;
+    }
+
+    // Returns the previous bit value.
+    bool set_atomic(std::size_t bit)
+    {
+        const uint64_t mask = 1ULL << (bit % 64);
+        return __atomic_fetch_or(&words[bit / 64], mask, __ATOMIC_RELAXED) & mask;
+    }
+
+    // Returns the previous bit value.
+    bool clear_atomic(std::size_t bit)
+    {
+        const uint64_t mask = 1ULL << (bit % 64);
+        return __atomic_fetch_and(&words[bit / 64], ~mask, __ATOMIC_RELAXED) & mask;
+    }
+
+    bool is_created() const { return words != NULL; }
+    std::size_t size() const { return nbits; }
+    std::size_t word_count() const { return (nbits + 63) / 64; }
+    const uint64_t * get_words() const { return words; }
+
+    std::size_t count() const
+    {
+        std::size_t n = 0;
+        for(std::size_t i = 0; i < word_count(); ++i)
+            n += __builtin_popcountll(__atomic_load_n(&words[i], __ATOMIC_RELAXED));
+        return n;
+    }
+
+    void copy_to(uint64_t * dst) const
+    {
+        for(std::size_t i = 0; i < word_count(); ++i)
+            dst[i] = __atomic_load_n(&words[i], __ATOMIC_RELAXED);
+    }
+
+    /*
+     *  Call fn(bit) for every set bit, in increasing bit order.
+     *  Runs of zero words are skipped a block at a time, the OR reduction of
+     *  a block is vectorized by the compiler.
+     */
+    template <typename FUNC>
+    static void for_each_set(const uint64_t * words, std::size_t word_count, FUNC fn)
+    {
+        enum {BLOCK_WORDS = 8};
+        std::size_t i = 0;
+        for(; i + BLOCK_WORDS <= word_count; i += BLOCK_WORDS)
+        {
+            uint64_t any = 0;
+            for(std::size_t j = 0; j < BLOCK_WORDS; ++j)
+                any |= words[i + j];
+            if(any == 0)
+                continue;
+
+            for(std::size_t j = i; j < i + BLOCK_WORDS; ++j)
+                for_each_set_in_word(words[j], j, fn);
+        }
+        for(; i < word_count; ++i)
+            for_each_set_in_word(words[i], i, fn);
+    }
+
+private:
+    template <typename FUNC>
+    static void for_each_set_in_word(uint64_t word, std::size_t word_idx, FUNC & fn)
+    {
+        while(word != 0)
+        {
+            fn(word_idx * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+
+    uint64_t * words;
+    std::size_t nbits;
+};
+
+#endif /* OBJMEMPOOL_BITMAP_H_ */
@@ -0,0 +1,98 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * objmempool_check.h
+ *
+ */
+
+#ifndef OBJMEMPOOL_CHECK_H_
+#define OBJMEMPOOL_CHECK_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cstddef>
+
+#include "objmempool_bitmap.h"
+
+/*
+ *  Pool checking mode (MEMPOOL_F_CHECKED) definitions.
+ */
+struct Objmempool_check
+{
+    enum Error {DOUBLE_FREE, USE_AFTER_FREE, INVALID_PTR};
+
+    typedef void (*func_report)(const char * pool_name, const void * obj, Error error);
+
+    // Sampled free checks, one of SAMPLE_RATE_DEFAULT (must be a power of 2).
+    // Checked objects are held back from reuse for QUARANTINE_SIZE checked frees.
+    enum {SAMPLE_RATE_DEFAULT = 64, QUARANTINE_SIZE = 16, POISON_BYTE = 0x6b};
+
+    static const char * error_str(Error error)
+    {
+        switch(error)
+        {
+        case DOUBLE_FREE:       return "double free";
+        case USE_AFTER_FREE:    return "use after free";
+        case INVALID_PTR:       return "invalid pointer";
+        default:                return "unknown";
+        }
+    }
+
+    static void report_default(const char * pool_name, const void * obj, Error error)
+    {
+        fprintf(stderr, "Mempool [%s]: %s of %p.\n", pool_name, error_str(error), obj);
+    }
+
+    static void poison(void * obj, std::size_t size)
+    {
+        memset(obj, POISON_BYTE, size);
+    }
+
+    static bool is_poisoned(const void * obj, std::size_t size)
+    {
+        const uint64_t pattern = 0x0101010101010101ULL * POISON_BYTE;
+        const uint8_t * byte = static_cast<const uint8_t*>(obj);
+        std::size_t i = 0;
+        for(; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            memcpy(&word, byte + i, sizeof(word));
+            if(word != pattern)
+                return false;
+        }
+        for(; i < size; ++i)
+            if(byte[i] != POISON_BYTE)
+                return false;
+        return true;
+    }
+};
+
+#endif /* OBJMEMPOOL_CHECK_H_ */
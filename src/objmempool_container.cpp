@@ -66,10 +66,14 @@ void Objmempool_container::clear()
 
 int Objmempool_container::show_cmd(int argc, const char **argv, char *buf, std::size_t buf_size)
 {
+    if(selfie == NULL)
+        return 0;
+
     mp_records & mpr = selfie->mprecord;
     char * const buf_base = buf;
 
-    for(mp_records::iterator record = mpr.begin(); record != mpr.end(); ++record )
+    // Each record writes at most buf_size - 1 characters and a terminator.
+    for(mp_records::iterator record = mpr.begin(); record != mpr.end() && buf_size > 1; ++record )
     {
         int ch_num = record->show_cmd(argc, argv, buf, buf_size);
 
@@ -35,6 +35,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define OBJMEMPOOL_CONTAINER_H_
 
 #include <stdint.h>
+#include <cstddef>
 #include <vector>
 
 class Objmempool_container
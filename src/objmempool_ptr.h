@@ -0,0 +1,215 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * objmempool_ptr.h
+ *
+ */
+
+#ifndef OBJMEMPOOL_PTR_H_
+#define OBJMEMPOOL_PTR_H_
+
+#include "objmempool.h"
+#include "objmempool_allocator.h"
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+ *  Pool aware smart pointers.
+ *
+ *  Objects of a type derived from Objmempool come from the type pool, other
+ *  types come from the Objmempool_allocator node pool of their type (created
+ *  on demand, see objmempool_allocator.h).
+ *
+ *  - make_pooled:            std::unique_ptr with a stateless pool deleter.
+ *  - make_pooled_shared:     Objmempool_shared_ptr, object and intrusive
+ *                            reference counter in a single pool slot.
+ *  - allocate_pooled_shared: std::shared_ptr with the control block and the
+ *                            object in a single pool slot (std::allocate_shared).
+ */
+
+template <typename T>
+struct Objmempool_is_pooled : std::is_base_of<Objmempool<T>, T> {};
+
+template <typename T>
+struct Objmempool_deleter
+{
+    Objmempool_deleter() {}
+    template <typename U>
+    Objmempool_deleter(const Objmempool_deleter<U> & other) { UNUSED(other); }
+
+    void operator()(T * obj) const
+    {
+        if constexpr (Objmempool_is_pooled<T>::value)
+        {
+            delete obj;
+        }
+        else
+        {
+            obj->~T();
+            Objmempool_allocator<T>().deallocate(obj, 1);
+        }
+    }
+};
+
+template <typename T>
+using Objmempool_unique_ptr = std::unique_ptr<T, Objmempool_deleter<T> >;
+
+template <typename T, typename... ARGS>
+Objmempool_unique_ptr<T> make_pooled(ARGS &&... args)
+{
+    if constexpr (Objmempool_is_pooled<T>::value)
+    {
+        return Objmempool_unique_ptr<T>(new T(std::forward<ARGS>(args)...));
+    }
+    else
+    {
+        Objmempool_allocator<T> alloc;
+        T * mem = alloc.allocate(1);
+        try
+        {
+            return Objmempool_unique_ptr<T>(new (mem) T(std::forward<ARGS>(args)...));
+        }
+        catch(...)
+        {
+            alloc.deallocate(mem, 1);
+            throw;
+        }
+    }
+}
+
+template <typename T, typename... ARGS>
+std::shared_ptr<T> allocate_pooled_shared(ARGS &&... args)
+{
+    return std::allocate_shared<T>(Objmempool_allocator<T>(), std::forward<ARGS>(args)...);
+}
+
+/*
+ *  Shared ownership, with the reference counter embedded in the object slot.
+ *  Lighter than std::shared_ptr (a single pointer, no weak references, no
+ *  aliasing, no custom deleters).
+ */
+template <typename T>
+class Objmempool_shared_ptr
+{
+    struct Block
+    {
+        template <typename... ARGS>
+        Block(ARGS &&... args) : refs(1), obj(std::forward<ARGS>(args)...) {}
+
+        std::atomic<long> refs;
+        T obj;
+    };
+
+public:
+    typedef T element_type;
+
+    Objmempool_shared_ptr() : block(NULL) {}
+    Objmempool_shared_ptr(const Objmempool_shared_ptr & other) : block(other.block) { acquire(); }
+    Objmempool_shared_ptr(Objmempool_shared_ptr && other) : block(other.block) { other.block = NULL; }
+    ~Objmempool_shared_ptr() { release(); }
+
+    Objmempool_shared_ptr & operator=(const Objmempool_shared_ptr & other)
+    {
+        if(block != other.block)
+        {
+            other.acquire();
+            release();
+            block = other.block;
+        }
+        return *this;
+    }
+
+    Objmempool_shared_ptr & operator=(Objmempool_shared_ptr && other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    void reset() { release(); block = NULL; }
+    void swap(Objmempool_shared_ptr & other) { std::swap(block, other.block); }
+
+    T * get() const { return block ? &block->obj : NULL; }
+    T & operator*() const { return block->obj; }
+    T * operator->() const { return &block->obj; }
+    explicit operator bool() const { return block != NULL; }
+
+    long use_count() const { return block ? block->refs.load(std::memory_order_relaxed) : 0; }
+
+    template <typename U, typename... ARGS>
+    friend Objmempool_shared_ptr<U> make_pooled_shared(ARGS &&... args);
+
+private:
+    explicit Objmempool_shared_ptr(Block * block_) : block(block_) {}
+
+    void acquire() const
+    {
+        if(block != NULL)
+            block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release()
+    {
+        if(block != NULL && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            block->~Block();
+            Objmempool_allocator<Block>().deallocate(block, 1);
+        }
+    }
+
+    Block * block;
+};
+
+template <typename T, typename... ARGS>
+Objmempool_shared_ptr<T> make_pooled_shared(ARGS &&... args)
+{
+    typedef typename Objmempool_shared_ptr<T>::Block Block;
+
+    Objmempool_allocator<Block> alloc;
+    Block * mem = alloc.allocate(1);
+    try
+    {
+        return Objmempool_shared_ptr<T>(new (mem) Block(std::forward<ARGS>(args)...));
+    }
+    catch(...)
+    {
+        alloc.deallocate(mem, 1);
+        throw;
+    }
+}
+
+template <typename T, typename U>
+inline bool operator==(const Objmempool_shared_ptr<T> & a, const Objmempool_shared_ptr<U> & b) { return a.get() == b.get(); }
+
+template <typename T, typename U>
+inline bool operator!=(const Objmempool_shared_ptr<T> & a, const Objmempool_shared_ptr<U> & b) { return a.get() != b.get(); }
+
+#endif /* OBJMEMPOOL_PTR_H_ */
@@ -0,0 +1,162 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * objmempool_resource.cpp
+ *
+ */
+
+#include "objmempool_resource.h"
+#include <pthread.h>
+
+static pthread_mutex_t class_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int class_refs[Objmempool_memory_resource::CLASS_COUNT];
+
+template <std::size_t SIZE>
+static void size_class_cache_destroy()
+{
+    Objmempool_size_class<SIZE>::mempool_cache_flush();
+    Objmempool_size_class<SIZE>::mempool_cache_destroy();
+}
+
+#define SIZE_CLASS_OPS(size) \
+    { Objmempool_size_class<size>::mempool_alloc, \
+      Objmempool_size_class<size>::mempool_free, \
+      Objmempool_size_class<size>::mempool_owns, \
+      Objmempool_size_class<size>::mempool_create, \
+      Objmempool_size_class<size>::mempool_destroy, \
+      Objmempool_size_class<size>::mempool_cache_create, \
+      size_class_cache_destroy<size> }
+
+const Objmempool_memory_resource::Class_ops Objmempool_memory_resource::class_ops[CLASS_COUNT] =
+{
+    SIZE_CLASS_OPS(16),
+    SIZE_CLASS_OPS(32),
+    SIZE_CLASS_OPS(64),
+    SIZE_CLASS_OPS(128),
+    SIZE_CLASS_OPS(256),
+    SIZE_CLASS_OPS(512),
+    SIZE_CLASS_OPS(1024),
+    SIZE_CLASS_OPS(2048),
+    SIZE_CLASS_OPS(4096),
+};
+
+Objmempool_memory_resource::Options::Options()
+    : min_class_size(MIN_CLASS_SIZE),
+      max_class_size(MAX_CLASS_SIZE),
+      obj_count(CLASS_OBJ_COUNT_DEFAULT)
+{
+    for(std::size_t i = 0; i < CLASS_COUNT; ++i)
+        class_obj_count[i] = 0;
+}
+
+Objmempool_memory_resource::Objmempool_memory_resource(const Options & options,
+                                                       std::pmr::memory_resource * upstream_)
+    : first_class(class_index(options.min_class_size)),
+      last_class(class_index(options.max_class_size)),
+      upstream(upstream_)
+{
+    if(last_class >= CLASS_COUNT)
+        last_class = CLASS_COUNT - 1;
+    if(first_class > last_class)
+        first_class = last_class;
+    max_size = class_size(last_class);
+
+    pthread_mutex_lock(&class_lock);
+    for(std::size_t i = first_class; i <= last_class; ++i)
+    {
+        if(class_refs[i]++ == 0)
+        {
+            std::size_t count = options.class_obj_count[i] ? options.class_obj_count[i] : options.obj_count;
+            class_ops[i].create(count, 0);
+        }
+    }
+    pthread_mutex_unlock(&class_lock);
+}
+
+Objmempool_memory_resource::~Objmempool_memory_resource()
+{
+    pthread_mutex_lock(&class_lock);
+    for(std::size_t i = first_class; i <= last_class; ++i)
+    {
+        if(--class_refs[i] == 0)
+            class_ops[i].destroy();
+    }
+    pthread_mutex_unlock(&class_lock);
+}
+
+void Objmempool_memory_resource::mempool_cache_create(std::size_t cache_size)
+{
+    for(std::size_t i = first_class; i <= last_class; ++i)
+        class_ops[i].cache_create(cache_size);
+}
+
+void Objmempool_memory_resource::mempool_cache_destroy()
+{
+    for(std::size_t i = first_class; i <= last_class; ++i)
+        class_ops[i].cache_destroy();
+}
+
+void * Objmempool_memory_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    if(likely(bytes <= max_size && alignment <= MAX_ALIGN))
+    {
+        std::size_t idx = class_index(bytes < alignment ? alignment : bytes);
+        if(idx < first_class)
+            idx = first_class;
+
+        void * ptr = class_ops[idx].alloc();
+        if(likely(ptr != NULL))
+            return ptr;
+    }
+
+    return upstream->allocate(bytes, alignment);
+}
+
+void Objmempool_memory_resource::do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment)
+{
+    if(likely(bytes <= max_size && alignment <= MAX_ALIGN))
+    {
+        std::size_t idx = class_index(bytes < alignment ? alignment : bytes);
+        if(idx < first_class)
+            idx = first_class;
+
+        if(likely(class_ops[idx].owns(ptr)))
+        {
+            class_ops[idx].free(ptr);
+            return;
+        }
+    }
+
+    upstream->deallocate(ptr, bytes, alignment);
+}
+
+bool Objmempool_memory_resource::do_is_equal(const std::pmr::memory_resource & other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,135 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * objmempool_resource.h
+ *
+ */
+
+#ifndef OBJMEMPOOL_RESOURCE_H_
+#define OBJMEMPOOL_RESOURCE_H_
+
+#include "objmempool.h"
+#include <memory_resource>
+#include <cstddef>
+
+/*
+ *  Size class slot: an Objmempool per power of 2 size class.
+ *  Slots are naturally aligned up to 16 bytes (the slab is malloc aligned).
+ */
+template <std::size_t SIZE>
+class Objmempool_size_class : public Objmempool<Objmempool_size_class<SIZE> >
+{
+    alignas(SIZE < 16 ? SIZE : 16) unsigned char storage[SIZE];
+};
+
+/*
+ *  std::pmr memory resource, serving small requests from size class pools.
+ *
+ *  Requests are rounded up to the next power of 2 class (16B .. 4KB) and served
+ *  from the class Objmempool (ring + per-thread cache), requests above the
+ *  largest enabled class, with an alignment above 16 or for which the class
+ *  pool is exhausted are forwarded to the upstream resource.
+ *
+ *  The class pools are process wide and reference counted: resources with
+ *  overlapping classes share the same pools, each pool is registered in the
+ *  Objmempool_container and destroyed with the last resource using it.
+ *  Like Objmempool, the resource is expected to be created at the application
+ *  global init stage and the caches at the thread init stage.
+ */
+class Objmempool_memory_resource : public std::pmr::memory_resource
+{
+public:
+    enum {MIN_CLASS_SHIFT = 4, MAX_CLASS_SHIFT = 12,
+          MIN_CLASS_SIZE = 1 << MIN_CLASS_SHIFT,
+          MAX_CLASS_SIZE = 1 << MAX_CLASS_SHIFT,
+          CLASS_COUNT = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1,
+          MAX_ALIGN = 16,
+          CLASS_OBJ_COUNT_DEFAULT = 4096,
+          CACHE_SIZE_DEFAULT = Objmempool_size_class<MIN_CLASS_SIZE>::CACHE_SIZE_DEFAULT};
+
+    struct Options
+    {
+        Options();
+
+        std::size_t min_class_size;                 // Power of 2, at least MIN_CLASS_SIZE.
+        std::size_t max_class_size;                 // Power of 2, at most MAX_CLASS_SIZE.
+        std::size_t obj_count;                      // Objects per class pool.
+        std::size_t class_obj_count[CLASS_COUNT];   // Per class override of obj_count (0 to ignore).
+    };
+
+    explicit Objmempool_memory_resource(const Options & options = Options(),
+                                        std::pmr::memory_resource * upstream = std::pmr::get_default_resource());
+    virtual ~Objmempool_memory_resource();
+
+    // Per thread caches for all the enabled classes, at the thread init stage.
+    void mempool_cache_create(std::size_t cache_size = CACHE_SIZE_DEFAULT);
+    void mempool_cache_destroy();
+
+    std::pmr::memory_resource * upstream_resource() const { return upstream; }
+
+    static std::size_t class_index(std::size_t bytes);
+    static std::size_t class_size(std::size_t index) { return std::size_t(MIN_CLASS_SIZE) << index; }
+
+protected:
+    virtual void * do_allocate(std::size_t bytes, std::size_t alignment);
+    virtual void do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment);
+    virtual bool do_is_equal(const std::pmr::memory_resource & other) const noexcept;
+
+private:
+    Objmempool_memory_resource(const Objmempool_memory_resource &);
+    Objmempool_memory_resource & operator=(const Objmempool_memory_resource &);
+
+    struct Class_ops
+    {
+        void * (*alloc)();
+        void (*free)(void * ptr);
+        bool (*owns)(const void * ptr);
+        void (*create)(std::size_t object_count, unsigned int flags);
+        void (*destroy)();
+        void (*cache_create)(std::size_t cache_size);
+        void (*cache_destroy)();
+    };
+    static const Class_ops class_ops[CLASS_COUNT];
+
+    std::size_t first_class;
+    std::size_t last_class;
+    std::size_t max_size;
+    std::pmr::memory_resource * upstream;
+};
+
+inline std::size_t Objmempool_memory_resource::class_index(std::size_t bytes)
+{
+    if(bytes <= MIN_CLASS_SIZE)
+        return 0;
+
+    // Index of the next power of 2 (bit width of bytes - 1), relative to the min class.
+    return (sizeof(unsigned long) * 8 - __builtin_clzl(bytes - 1)) - MIN_CLASS_SHIFT;
+}
+
+#endif /* OBJMEMPOOL_RESOURCE_H_ */
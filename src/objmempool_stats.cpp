@@ -0,0 +1,173 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * objmempool_stats.cpp
+ *
+ */
+
+#include "objmempool_stats.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+static uint32_t page_ids = 0;
+static Objmempool_stats::Thread_slot overflow_slot;    // Process local, not published.
+
+Objmempool_stats::Page * Objmempool_stats::create(const char * name, std::size_t obj_size, std::size_t obj_count)
+{
+    Page header = Page();
+    header.pid = getpid();
+    header.id = __atomic_fetch_add(&page_ids, 1, __ATOMIC_RELAXED);
+
+    char shm[64];
+    shm_name(&header, shm, sizeof(shm));
+
+    int fd = shm_open(shm, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if(fd < 0)
+        return NULL;
+
+    Page * page = NULL;
+    if(ftruncate(fd, sizeof(Page)) == 0)
+    {
+        void * mem = mmap(NULL, sizeof(Page), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(mem != MAP_FAILED)
+            page = static_cast<Page*>(mem);
+    }
+    ::close(fd);
+
+    if(page == NULL)
+    {
+        shm_unlink(shm);
+        return NULL;
+    }
+
+    page->version = VERSION;
+    page->page_size = sizeof(Page);
+    page->pid = header.pid;
+    page->id = header.id;
+    strncpy(page->name, name, NAME_SIZE - 1);
+    page->obj_size = obj_size;
+    page->obj_count = obj_count;
+    __atomic_store_n(&page->magic, (uint32_t)MAGIC, __ATOMIC_RELEASE);
+
+    return page;
+}
+
+void Objmempool_stats::destroy(Page * page)
+{
+    if(page == NULL)
+        return;
+
+    char shm[64];
+    shm_name(page, shm, sizeof(shm));
+    shm_unlink(shm);
+    munmap(page, sizeof(Page));
+}
+
+Objmempool_stats::Thread_slot * Objmempool_stats::thread_slot_claim(Page * page)
+{
+    const uint32_t idx = __atomic_fetch_add(&page->thread_slots_used, 1, __ATOMIC_RELAXED);
+    if(idx >= THREAD_SLOTS)
+        return &overflow_slot;
+
+    Thread_slot * slot = &page->threads[idx];
+    __atomic_store_n(&slot->tid, (uint32_t)syscall(SYS_gettid), __ATOMIC_RELEASE);
+    return slot;
+}
+
+const Objmempool_stats::Page * Objmempool_stats::open(const char * shm_name)
+{
+    int fd = shm_open(shm_name, O_RDONLY, 0);
+    if(fd < 0)
+        return NULL;
+
+    const Page * page = NULL;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(Page))
+    {
+        void * mem = mmap(NULL, sizeof(Page), PROT_READ, MAP_SHARED, fd, 0);
+        if(mem != MAP_FAILED)
+            page = static_cast<const Page*>(mem);
+    }
+    ::close(fd);
+
+    if(page != NULL &&
+       (__atomic_load_n(&page->magic, __ATOMIC_ACQUIRE) != MAGIC || page->version != VERSION))
+    {
+        close(page);
+        page = NULL;
+    }
+    return page;
+}
+
+void Objmempool_stats::close(const Page * page)
+{
+    if(page != NULL)
+        munmap(const_cast<Page*>(page), sizeof(Page));
+}
+
+/*
+ *  Returns false when no consistent copy was read, e.g. the writer died in
+ *  the middle of an update.
+ */
+bool Objmempool_stats::slot_read(const Thread_slot * slot, Thread_slot & out)
+{
+    enum {READ_RETRIES = 1000};
+
+    for(int retry = 0; retry < READ_RETRIES; ++retry)
+    {
+        const uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if(seq & 1)
+            continue;
+
+        out.tid            = __atomic_load_n(&slot->tid, __ATOMIC_RELAXED);
+        out.refills        = __atomic_load_n(&slot->refills, __ATOMIC_RELAXED);
+        out.flushes        = __atomic_load_n(&slot->flushes, __ATOMIC_RELAXED);
+        out.alloc_failures = __atomic_load_n(&slot->alloc_failures, __ATOMIC_RELAXED);
+        out.ring_out       = __atomic_load_n(&slot->ring_out, __ATOMIC_RELAXED);
+        out.cached         = __atomic_load_n(&slot->cached, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if(__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq)
+        {
+            out.seq = seq;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Objmempool_stats::shm_name(const Page * page, char * buf, std::size_t buf_size)
+{
+    snprintf(buf, buf_size, "/%s%u.%u", shm_prefix(), page->pid, page->id);
+}
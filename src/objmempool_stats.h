@@ -0,0 +1,112 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * objmempool_stats.h
+ *
+ */
+
+#ifndef OBJMEMPOOL_STATS_H_
+#define OBJMEMPOOL_STATS_H_
+
+#include <stdint.h>
+#include <cstddef>
+
+/*
+ *  Pool statistics page (MEMPOOL_F_STATS)
+ *  Each pool publishes its counters in a shared memory object named
+ *  /objmempool.<pid>.<id>, read by external tools (tools/pool_top) without
+ *  any cooperation from the process.
+ *
+ *  The header is written once at creation. The counters are kept per thread,
+ *  each thread slot has a single writer (its owner thread) and is protected
+ *  by a seqlock: The updates are plain stores on the pool slow path (ring
+ *  refill/flush), no syscall and no atomic read-modify-write.
+ *  Threads beyond THREAD_SLOTS are not reported.
+ */
+struct Objmempool_stats
+{
+    enum {MAGIC = 0x4f4d5053, VERSION = 1, NAME_SIZE = 128, THREAD_SLOTS = 64};
+
+    struct Thread_slot
+    {
+        uint32_t seq;               // Odd while an update is in progress.
+        uint32_t tid;               // 0 for an unused slot.
+        uint64_t refills;           // Ring dequeue operations (single objects without a cache).
+        uint64_t flushes;           // Ring enqueue operations (single objects without a cache).
+        uint64_t alloc_failures;
+        int64_t  ring_out;          // Objects taken from the ring minus objects returned.
+        uint64_t cached;            // Thread cache length after the last ring operation.
+    } __attribute__((aligned(64)));
+
+    struct Page
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t page_size;
+        uint32_t pid;
+        uint32_t id;                 // Process unique page id.
+        char     name[NAME_SIZE];
+        uint64_t obj_size;
+        uint64_t obj_count;
+        uint32_t thread_slots_used;  // Claimed once, in order.
+        Thread_slot threads[THREAD_SLOTS];
+    };
+
+    // Writer side, returns NULL when the page can't be created.
+    static Page * create(const char * name, std::size_t obj_size, std::size_t obj_count);
+    static void destroy(Page * page);
+    static Thread_slot * thread_slot_claim(Page * page);
+
+    static void slot_update_begin(Thread_slot * slot)
+    {
+        __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    static void slot_update_end(Thread_slot * slot)
+    {
+        __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+    }
+
+    template <typename T>
+    static void slot_store(T * field, T value)
+    {
+        __atomic_store_n(field, value, __ATOMIC_RELAXED);
+    }
+
+    // Reader side.
+    static const Page * open(const char * shm_name);
+    static void close(const Page * page);
+    static bool slot_read(const Thread_slot * slot, Thread_slot & out);
+
+    static const char * shm_prefix() { return "objmempool."; }
+    static void shm_name(const Page * page, char * buf, std::size_t buf_size);
+};
+
+#endif /* OBJMEMPOOL_STATS_H_ */
@@ -0,0 +1,219 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * pool_top.cpp
+ *
+ */
+
+/*
+ *  pool_top: Samples the statistics pages published by MEMPOOL_F_STATS pools
+ *  (see objmempool_stats.h). The pages are mapped read only, the sampled
+ *  processes are not involved.
+ *
+ *  Usage: pool_top [-p pid] [-i interval_ms] [-n samples]
+ */
+
+#include "objmempool_stats.h"
+
+#include <cxxabi.h>
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+
+struct Pool_sample
+{
+    uint64_t refills;
+    uint64_t flushes;
+    uint64_t alloc_failures;
+    int64_t  ring_out;
+    uint64_t cached;
+    uint32_t threads;
+};
+
+struct Pool_view
+{
+    const Objmempool_stats::Page * page;
+    Pool_sample last;
+    bool seen;
+};
+
+typedef std::map<std::string, Pool_view> Pool_views;
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static Pool_sample sample(const Objmempool_stats::Page * page)
+{
+    Pool_sample s = Pool_sample();
+    uint32_t used = __atomic_load_n(&page->thread_slots_used, __ATOMIC_RELAXED);
+    if(used > Objmempool_stats::THREAD_SLOTS)
+        used = Objmempool_stats::THREAD_SLOTS;
+
+    for(uint32_t i = 0; i < used; ++i)
+    {
+        Objmempool_stats::Thread_slot slot;
+        if(! Objmempool_stats::slot_read(&page->threads[i], slot) || slot.tid == 0)
+            continue;
+
+        s.refills += slot.refills;
+        s.flushes += slot.flushes;
+        s.alloc_failures += slot.alloc_failures;
+        s.ring_out += slot.ring_out;
+        s.cached += slot.cached;
+        ++s.threads;
+    }
+    return s;
+}
+
+// Map the pages of the new pools, forget the removed ones.
+static void scan(Pool_views & views, unsigned int pid)
+{
+    for(Pool_views::iterator view = views.begin(); view != views.end(); ++view)
+        view->second.seen = false;
+
+    DIR * dir = opendir("/dev/shm");
+    if(dir != NULL)
+    {
+        const size_t prefix_len = strlen(Objmempool_stats::shm_prefix());
+        while(struct dirent * entry = readdir(dir))
+        {
+            if(strncmp(entry->d_name, Objmempool_stats::shm_prefix(), prefix_len) != 0)
+                continue;
+            if(pid != 0 && strtoul(entry->d_name + prefix_len, NULL, 10) != pid)
+                continue;
+
+            const std::string name = std::string("/") + entry->d_name;
+            Pool_views::iterator view = views.find(name);
+            if(view == views.end())
+            {
+                const Objmempool_stats::Page * page = Objmempool_stats::open(name.c_str());
+                if(page == NULL)
+                    continue;
+                Pool_view new_view = {page, sample(page), false};
+                view = views.insert(std::make_pair(name, new_view)).first;
+            }
+            view->second.seen = true;
+        }
+        closedir(dir);
+    }
+
+    for(Pool_views::iterator view = views.begin(); view != views.end(); )
+    {
+        if(view->second.seen)
+        {
+            ++view;
+            continue;
+        }
+        Objmempool_stats::close(view->second.page);
+        views.erase(view++);
+    }
+}
+
+static void show(Pool_views & views, double interval_s)
+{
+    printf("%8s %-32s %10s %10s %8s %4s %12s %12s %10s\n",
+           "PID", "POOL", "SIZE", "FREE", "CACHED", "THR", "REFILL/s", "FLUSH/s", "FAILURES");
+
+    for(Pool_views::iterator view = views.begin(); view != views.end(); ++view)
+    {
+        const Objmempool_stats::Page * page = view->second.page;
+        const Pool_sample cur = sample(page);
+        const Pool_sample & last = view->second.last;
+
+        int status;
+        char * demangled = abi::__cxa_demangle(page->name, NULL, NULL, &status);
+        const bool alive = (kill(page->pid, 0) == 0 || errno == EPERM);
+
+        printf("%8u %-32.32s %10llu %10lld %8llu %4u %12.0f %12.0f %10llu%s\n",
+               page->pid,
+               (status == 0) ? demangled : page->name,
+               (unsigned long long)page->obj_count,
+               (long long)page->obj_count - cur.ring_out,
+               (unsigned long long)cur.cached,
+               cur.threads,
+               (cur.refills - last.refills) / interval_s,
+               (cur.flushes - last.flushes) / interval_s,
+               (unsigned long long)cur.alloc_failures,
+               alive ? "" : " (dead)");
+
+        free(demangled);
+        view->second.last = cur;
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+int main(int argc, char ** argv)
+{
+    unsigned int pid = 0;
+    unsigned int interval_ms = 1000;
+    unsigned long samples = 0;
+
+    int opt;
+    while((opt = getopt(argc, argv, "p:i:n:")) != -1)
+    {
+        switch(opt)
+        {
+        case 'p': pid = strtoul(optarg, NULL, 10); break;
+        case 'i': interval_ms = strtoul(optarg, NULL, 10); break;
+        case 'n': samples = strtoul(optarg, NULL, 10); break;
+        default:
+            fprintf(stderr, "Usage: %s [-p pid] [-i interval_ms] [-n samples]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Pool_views views;
+    scan(views, pid);
+    uint64_t last = now_ns();
+
+    for(unsigned long i = 0; samples == 0 || i < samples; ++i)
+    {
+        usleep(interval_ms * 1000);
+        const uint64_t now = now_ns();
+        scan(views, pid);
+        show(views, (now - last) / 1e9);
+        last = now;
+    }
+
+    for(Pool_views::iterator view = views.begin(); view != views.end(); ++view)
+        Objmempool_stats::close(view->second.page);
+    return 0;
+}
@@ -15,8 +15,10 @@ ifeq ($(CPPUTEST_ENABLE_C99), Y)
 	CPPUTEST_CFLAGS += -std=c99
 endif
 
-ifeq ($(CPPUTEST_ENABLE_C++11), Y)
-	CPPUTEST_CXXFLAGS += -std=c++11
+ifeq ($(CPPUTEST_ENABLE_C++17), Y)
+	CPPUTEST_CXXFLAGS += -std=gnu++17
+else ifeq ($(CPPUTEST_ENABLE_C++11), Y)
+	CPPUTEST_CXXFLAGS += -std=gnu++11
 endif
 
 CPPUTEST_CXXFLAGS += -include $(TEST_ROOT)/mocks/include/oper_new_mock.h
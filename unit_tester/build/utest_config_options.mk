@@ -6,7 +6,8 @@ CPPUTEST_MEMORY_LEAK_DETECTION ?= Y
 
 CPPUTEST_ENABLE_DEBUG ?= Y
 CPPUTEST_ENABLE_C99 ?= N
-CPPUTEST_ENABLE_C++11 ?= N
+CPPUTEST_ENABLE_C++11 ?= Y
+CPPUTEST_ENABLE_C++17 ?= Y
 CPPUTEST_USE_GCOV ?= Y
 CPPUTEST_PEDANTIC_ERRORS ?= N
 
@@ -22,6 +23,8 @@ CPPUTEST_USE_VPATH ?= N
 # Default warnings	 
 ifndef CPPUTEST_WARNINGFLAGS
 	CPPUTEST_WARNINGFLAGS =  -Wall -Wextra -Wshadow -Wswitch-default -Wformat -Werror
+	# The rte_ring copy macros rely on switch case fall-through.
+	CPPUTEST_WARNINGFLAGS += -Wno-implicit-fallthrough
 	ifeq ($(CPPUTEST_PEDANTIC_ERRORS), Y)
 		CPPUTEST_WARNINGFLAGS += -pedantic-errors
 	endif 
@@ -29,4 +32,4 @@ ifndef CPPUTEST_WARNINGFLAGS
 endif
 
 # Link to other libraries
-LD_LIBRARIES += -lpthread
\ No newline at end of file
+LD_LIBRARIES += -lpthread -lrt
\ No newline at end of file
@@ -36,6 +36,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "objmempool.h"
 #include "objmempool_container.h"
 
+#include <string.h>
+
 class Test_object : public Objmempool<Test_object>
 {
 public:
@@ -173,6 +175,24 @@ TEST(mempool, show_cmd_for_all_objmempools)
     Test_object_ctor::mempool_destroy();
 }
 
+TEST(mempool, show_cmd_small_buffer__output_bounded)
+{
+    const size_t pool_size = 32;
+    Test_object_ctor::mempool_create(pool_size);
+
+    const size_t buf_size = 16;
+    char buf[buf_size + 8];
+    memset(buf, 'x', sizeof(buf));
+    int ch_num = Objmempool_container::show_cmd(0, NULL, buf, buf_size);
+
+    CHECK(ch_num < (int)buf_size);
+    LONGS_EQUAL('\0', buf[ch_num]);
+    for(size_t i = buf_size; i < sizeof(buf); ++i)
+        LONGS_EQUAL('x', buf[i]);
+
+    Test_object_ctor::mempool_destroy();
+}
+
 #include <pthread.h>
 #include <unistd.h>
 
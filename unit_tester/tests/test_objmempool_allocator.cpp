@@ -0,0 +1,157 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * test_objmempool_allocator.cpp
+ *
+ */
+
+#include "CppUTest/TestHarness.h"
+
+#include "objmempool_allocator.h"
+#include "objmempool_container.h"
+
+#include <list>
+#include <map>
+#include <unordered_map>
+
+struct Test_node
+{
+    uint64_t key;
+    uint64_t value;
+};
+
+TEST_GROUP(mempool_allocator)
+{
+    void setup()
+    {
+
+    }
+
+    void teardown()
+    {
+        Objmempool_allocator_base::mempool_destroy_all();
+        Objmempool_allocator_base::set_pool_size(Objmempool_allocator_base::POOL_SIZE_DEFAULT);
+
+        Objmempool_container::clear();
+    }
+};
+
+TEST(mempool_allocator, allocate_1_object__object_provided_from_pool)
+{
+    typedef Objmempool_allocator<Test_node> Allocator;
+    Allocator alloc;
+
+    Test_node * node = alloc.allocate(1);
+    CHECK(Allocator::pool_type::mempool_owns(node));
+    LONGS_EQUAL(Allocator::POOL_SIZE_DEFAULT - 1, Allocator::pool_type::get_mempool_size());
+
+    alloc.deallocate(node, 1);
+}
+
+TEST(mempool_allocator, allocate_object_array__array_provided_from_heap)
+{
+    typedef Objmempool_allocator<Test_node> Allocator;
+    Allocator alloc;
+
+    Test_node * nodes = alloc.allocate(4);
+    CHECK_FALSE(Allocator::pool_type::mempool_owns(nodes));
+
+    alloc.deallocate(nodes, 4);
+}
+
+TEST(mempool_allocator, exhaust_pool__objects_provided_from_heap)
+{
+    typedef Objmempool_allocator<Test_node> Allocator;
+    const size_t pool_size = 64;
+    const size_t num = 2 * pool_size;
+    Allocator alloc;
+    Test_node * nodes[num];
+
+    Objmempool_allocator_base::set_pool_size(pool_size);
+
+    size_t pool_objs = 0;
+    for(size_t i = 0; i < num; ++i)
+    {
+        nodes[i] = alloc.allocate(1);
+        nodes[i]->key = i;
+        if(Allocator::pool_type::mempool_owns(nodes[i]))
+            ++pool_objs;
+    }
+    CHECK(pool_objs > 0);
+    CHECK(pool_objs < pool_size);
+
+    for(size_t i = 0; i < num; ++i)
+    {
+        LONGS_EQUAL(i, nodes[i]->key);
+        alloc.deallocate(nodes[i], 1);
+    }
+}
+
+TEST(mempool_allocator, std_list_insert_erase__list_node_pool_created)
+{
+    std::list<int, Objmempool_allocator<int> > lst;
+
+    for(int i = 0; i < 100; ++i)
+        lst.push_back(i);
+    LONGS_EQUAL(1, Objmempool_container::size());
+
+    int expected = 0;
+    for(std::list<int, Objmempool_allocator<int> >::iterator it = lst.begin(); it != lst.end(); ++it, ++expected)
+        LONGS_EQUAL(expected, *it);
+
+    lst.clear();
+}
+
+TEST(mempool_allocator, std_map_and_unordered_map_insert_find_erase__data_integrity)
+{
+    typedef std::map<int, int, std::less<int>, Objmempool_allocator<std::pair<const int, int> > > Map;
+    typedef std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+                               Objmempool_allocator<std::pair<const int, int> > > Hash_map;
+    Map map;
+    Hash_map hmap;
+
+    for(int i = 0; i < 1000; ++i)
+    {
+        map[i] = i * 2;
+        hmap[i] = i * 3;
+    }
+
+    for(int i = 0; i < 1000; i += 2)
+    {
+        map.erase(i);
+        hmap.erase(i);
+    }
+
+    LONGS_EQUAL(500, map.size());
+    LONGS_EQUAL(500, hmap.size());
+    LONGS_EQUAL(2 * 501, map.find(501)->second);
+    LONGS_EQUAL(3 * 501, hmap.find(501)->second);
+    CHECK(map.find(500) == map.end());
+    CHECK(hmap.find(500) == hmap.end());
+}
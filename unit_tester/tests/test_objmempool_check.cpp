@@ -0,0 +1,177 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * test_objmempool_check.cpp
+ *
+ */
+
+#include "CppUTest/TestHarness.h"
+
+#include "objmempool.h"
+#include "objmempool_container.h"
+
+class Test_checked_object : public Objmempool<Test_checked_object>
+{
+public:
+    Test_checked_object() : value(0) {}
+
+    uint64_t value;
+    char data[56];
+};
+
+static int report_count[Objmempool_check::INVALID_PTR + 1];
+static const void * report_obj;
+
+static void report_count_error(const char * pool_name, const void * obj, Objmempool_check::Error error)
+{
+    UNUSED(pool_name);
+    ++report_count[error];
+    report_obj = obj;
+}
+
+enum {POOL_SIZE = 128};
+TEST_GROUP(mempool_check)
+{
+    void setup()
+    {
+        memset(report_count, 0, sizeof(report_count));
+        report_obj = NULL;
+        Test_checked_object::mempool_create(POOL_SIZE, Test_checked_object::MEMPOOL_F_CHECKED);
+        Test_checked_object::mempool_check_set(1, report_count_error);
+    }
+
+    void teardown()
+    {
+        Test_checked_object::mempool_cache_destroy();
+        Test_checked_object::mempool_check_set();
+        Test_checked_object::mempool_destroy();
+        Objmempool_container::clear();
+    }
+};
+
+TEST(mempool_check, double_delete_no_cache__detected_and_pool_intact)
+{
+    Test_checked_object * obj = new Test_checked_object;
+    delete obj;
+    delete obj;
+
+    LONGS_EQUAL(1, report_count[Objmempool_check::DOUBLE_FREE]);
+    POINTERS_EQUAL(obj, report_obj);
+    LONGS_EQUAL(1, Test_checked_object::get_mempool_check_error_count());
+
+    Test_checked_object::mempool_cache_flush();
+    LONGS_EQUAL(POOL_SIZE - 1, Test_checked_object::get_mempool_free_obj_count());
+}
+
+TEST(mempool_check, double_delete_cache__detected)
+{
+    Test_checked_object::mempool_cache_create();
+
+    Test_checked_object * obj = new Test_checked_object;
+    delete obj;
+    delete obj;
+
+    LONGS_EQUAL(1, report_count[Objmempool_check::DOUBLE_FREE]);
+
+    Test_checked_object::mempool_cache_flush();
+    LONGS_EQUAL(POOL_SIZE - 1, Test_checked_object::get_mempool_free_obj_count());
+}
+
+TEST(mempool_check, double_delete_sampled__detected_when_any_free_sampled)
+{
+    Test_checked_object::mempool_check_set(2, report_count_error);
+    Test_checked_object::mempool_cache_create();
+
+    Test_checked_object * first = new Test_checked_object;
+    Test_checked_object * second = new Test_checked_object;
+    delete first;       // Not sampled, kept in the cache.
+    delete first;       // Sampled, found in the cache.
+    delete second;      // Not sampled.
+    delete second;      // Sampled.
+
+    LONGS_EQUAL(2, report_count[Objmempool_check::DOUBLE_FREE]);
+}
+
+TEST(mempool_check, checked_free_then_alloc__no_false_report)
+{
+    Test_checked_object::mempool_cache_create();
+
+    for(int i = 0; i < POOL_SIZE * 4; ++i)
+        delete new Test_checked_object;
+    Test_checked_object::mempool_cache_flush();
+
+    LONGS_EQUAL(POOL_SIZE - 1, Test_checked_object::get_mempool_free_obj_count());
+    LONGS_EQUAL(0, Test_checked_object::get_mempool_check_error_count());
+}
+
+TEST(mempool_check, invalid_pointer__detected)
+{
+    Test_checked_object::mempool_cache_create();
+
+    Test_checked_object * obj = new Test_checked_object;
+    Test_checked_object::mempool_free(reinterpret_cast<char*>(obj) + 1);
+    Test_checked_object local;
+    Test_checked_object::mempool_free(&local);
+
+    LONGS_EQUAL(2, report_count[Objmempool_check::INVALID_PTR]);
+    delete obj;
+}
+
+TEST(mempool_check, write_after_free__detected_on_quarantine_release)
+{
+    Test_checked_object::mempool_cache_create();
+
+    Test_checked_object * obj = new Test_checked_object;
+    delete obj;
+    obj->value = 0x1234;
+
+    Test_checked_object * objs[Objmempool_check::QUARANTINE_SIZE];
+    for(int i = 0; i < Objmempool_check::QUARANTINE_SIZE; ++i)
+    {
+        objs[i] = new Test_checked_object;
+        CHECK(objs[i] != obj);
+    }
+    LONGS_EQUAL(0, report_count[Objmempool_check::USE_AFTER_FREE]);
+
+    for(int i = 0; i < Objmempool_check::QUARANTINE_SIZE; ++i)
+        delete objs[i];
+    LONGS_EQUAL(1, report_count[Objmempool_check::USE_AFTER_FREE]);
+    POINTERS_EQUAL(obj, report_obj);
+}
+
+TEST(mempool_check, write_after_free__detected_on_flush)
+{
+    Test_checked_object * obj = new Test_checked_object;
+    delete obj;
+    obj->data[0] = 'x';
+
+    Test_checked_object::mempool_cache_flush();
+    LONGS_EQUAL(1, report_count[Objmempool_check::USE_AFTER_FREE]);
+    LONGS_EQUAL(POOL_SIZE - 1, Test_checked_object::get_mempool_free_obj_count());
+}
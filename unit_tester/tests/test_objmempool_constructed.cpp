@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * test_objmempool_constructed.cpp
+ *
+ */
+
+#include "CppUTest/TestHarness.h"
+
+#include "objmempool.h"
+#include "objmempool_container.h"
+
+#include <string.h>
+
+class Test_constructed_object : public Objmempool<Test_constructed_object>
+{
+public:
+    enum {BUF_SIZE = 256};
+
+    Test_constructed_object() : used(0), buf(new char[BUF_SIZE]) { ++ctor_count; }
+    ~Test_constructed_object() { delete [] buf; ++dtor_count; }
+
+    void mempool_obj_reset() { used = 0; ++reset_count; }
+
+    void append(const char * str) { size_t len = strlen(str); memcpy(buf + used, str, len); used += len; }
+    size_t get_used() { return used; }
+    const char * get_buf() { return buf; }
+
+    static int ctor_count;
+    static int dtor_count;
+    static int reset_count;
+
+private:
+    size_t used;
+    char * buf;
+};
+
+int Test_constructed_object::ctor_count = 0;
+int Test_constructed_object::dtor_count = 0;
+int Test_constructed_object::reset_count = 0;
+
+class Test_constructed_object_hook : public Objmempool<Test_constructed_object_hook>
+{
+public:
+    Test_constructed_object_hook(int id_) : id(id_) {}
+
+    static void mempool_obj_construct(void * slot) { ::new (slot) Test_constructed_object_hook(42); }
+
+    int id;
+};
+
+enum {POOL_SIZE = 128};
+TEST_GROUP(mempool_constructed)
+{
+    void setup()
+    {
+        Test_constructed_object::ctor_count = 0;
+        Test_constructed_object::dtor_count = 0;
+        Test_constructed_object::reset_count = 0;
+        Test_constructed_object::mempool_create(POOL_SIZE, Test_constructed_object::MEMPOOL_F_CONSTRUCTED);
+    }
+
+    void teardown()
+    {
+        Test_constructed_object::mempool_destroy();
+        Objmempool_container::clear();
+    }
+};
+
+TEST(mempool_constructed, create_pool__all_slots_constructed_once)
+{
+    LONGS_EQUAL(POOL_SIZE - 1, Test_constructed_object::ctor_count);
+}
+
+TEST(mempool_constructed, acquire_release__no_ctor_dtor_and_reset_on_release)
+{
+    Test_constructed_object * obj = Test_constructed_object::mempool_acquire();
+    obj->append("abc");
+    LONGS_EQUAL(3, obj->get_used());
+
+    Test_constructed_object::mempool_release(obj);
+    LONGS_EQUAL(1, Test_constructed_object::reset_count);
+    LONGS_EQUAL(0, obj->get_used());
+
+    Test_constructed_object * again = Test_constructed_object::mempool_acquire();
+    CHECK(again->get_buf() != NULL);
+    LONGS_EQUAL(0, again->get_used());
+    Test_constructed_object::mempool_release(again);
+
+    LONGS_EQUAL(POOL_SIZE - 1, Test_constructed_object::ctor_count);
+    LONGS_EQUAL(0, Test_constructed_object::dtor_count);
+}
+
+TEST(mempool_constructed, acquire_from_cache__constructed_objects)
+{
+    Test_constructed_object::mempool_cache_create();
+
+    Test_constructed_object * obj = Test_constructed_object::mempool_acquire();
+    CHECK(obj->get_buf() != NULL);
+    LONGS_EQUAL(0, obj->get_used());
+    Test_constructed_object::mempool_release(obj);
+
+    Test_constructed_object::mempool_cache_flush();
+    Test_constructed_object::mempool_cache_destroy();
+    LONGS_EQUAL(POOL_SIZE - 1, Test_constructed_object::get_mempool_free_obj_count());
+}
+
+TEST(mempool_constructed, destroy_pool__all_slots_destroyed)
+{
+    Test_constructed_object::mempool_destroy();
+    LONGS_EQUAL(POOL_SIZE - 1, Test_constructed_object::dtor_count);
+}
+
+TEST(mempool_constructed, construct_hook__type_without_default_ctor)
+{
+    Test_constructed_object_hook::mempool_create(POOL_SIZE, Test_constructed_object_hook::MEMPOOL_F_CONSTRUCTED);
+
+    Test_constructed_object_hook * obj = Test_constructed_object_hook::mempool_acquire();
+    LONGS_EQUAL(42, obj->id);
+    Test_constructed_object_hook::mempool_release(obj);
+
+    Test_constructed_object_hook::mempool_destroy();
+}
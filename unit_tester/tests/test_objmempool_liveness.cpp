@@ -0,0 +1,133 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * test_objmempool_liveness.cpp
+ *
+ */
+
+#include "CppUTest/TestHarness.h"
+
+#include "objmempool.h"
+#include "objmempool_container.h"
+
+#include <pthread.h>
+#include <algorithm>
+#include <vector>
+
+class Test_live_object : public Objmempool<Test_live_object>
+{
+public:
+    uint64_t id;
+    uint64_t data[3];
+};
+
+static std::vector<Test_live_object*> visit_live()
+{
+    std::vector<Test_live_object*> visited;
+    Test_live_object::for_each_live([&visited](Test_live_object * obj) { visited.push_back(obj); });
+    return visited;
+}
+
+enum {POOL_SIZE = 256};
+TEST_GROUP(mempool_liveness)
+{
+    void setup()
+    {
+        Test_live_object::mempool_create(POOL_SIZE, Test_live_object::MEMPOOL_F_LIVENESS);
+    }
+
+    void teardown()
+    {
+        Test_live_object::mempool_cache_destroy();
+        Test_live_object::mempool_destroy();
+        Objmempool_container::clear();
+    }
+};
+
+TEST(mempool_liveness, empty_pool__no_visit)
+{
+    LONGS_EQUAL(0, visit_live().size());
+}
+
+TEST(mempool_liveness, alloc_no_cache__live_objects_visited_in_address_order)
+{
+    std::vector<Test_live_object*> objs;
+    for(int i = 0; i < 100; ++i)
+        objs.push_back(new Test_live_object);
+    for(int i = 0; i < 100; i += 2)
+        delete objs[i];
+
+    std::vector<Test_live_object*> visited = visit_live();
+    LONGS_EQUAL(50, visited.size());
+    for(size_t i = 1; i < visited.size(); ++i)
+        CHECK(visited[i - 1] < visited[i]);
+    for(int i = 1; i < 100; i += 2)
+        CHECK(std::find(visited.begin(), visited.end(), objs[i]) != visited.end());
+
+    for(int i = 1; i < 100; i += 2)
+        delete objs[i];
+    LONGS_EQUAL(0, visit_live().size());
+}
+
+TEST(mempool_liveness, alloc_with_cache__cached_objects_not_visited)
+{
+    Test_live_object::mempool_cache_create();
+
+    Test_live_object * objs[5];
+    for(int i = 0; i < 5; ++i)
+        objs[i] = new Test_live_object;
+    LONGS_EQUAL(5, visit_live().size());
+
+    for(int i = 0; i < 5; ++i)
+        delete objs[i];
+    LONGS_EQUAL(0, visit_live().size());
+}
+
+static void * thread_alloc(void * arg)
+{
+    Test_live_object ** objs = static_cast<Test_live_object**>(arg);
+    Test_live_object::mempool_cache_create();
+    for(int i = 0; i < 3; ++i)
+        objs[i] = new Test_live_object;
+    return NULL;
+}
+
+TEST(mempool_liveness, thread_exit_without_cache_destroy__cache_returned)
+{
+    Test_live_object * objs[3];
+    pthread_t thread;
+    pthread_create(&thread, NULL, thread_alloc, objs);
+    pthread_join(thread, NULL);
+
+    LONGS_EQUAL(3, visit_live().size());
+    LONGS_EQUAL(POOL_SIZE - 1 - 3, Test_live_object::get_mempool_free_obj_count());
+
+    for(int i = 0; i < 3; ++i)
+        delete objs[i];
+}
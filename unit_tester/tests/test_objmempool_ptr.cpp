@@ -0,0 +1,134 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * test_objmempool_ptr.cpp
+ *
+ */
+
+#include "CppUTest/TestHarness.h"
+
+#include "objmempool_ptr.h"
+#include "objmempool_container.h"
+
+class Test_pooled_object : public Objmempool<Test_pooled_object>
+{
+public:
+    Test_pooled_object(uint64_t id_) : id(id_) {}
+
+    uint64_t get_id() {return this->id;}
+
+private:
+    uint64_t id;
+};
+
+struct Test_plain_object
+{
+    Test_plain_object(int id_) : id(id_) { ++live; }
+    ~Test_plain_object() { --live; }
+
+    int id;
+    static int live;
+};
+
+int Test_plain_object::live = 0;
+
+enum {POOL_SIZE = 64};
+TEST_GROUP(mempool_ptr)
+{
+    void setup()
+    {
+        Test_pooled_object::mempool_create(POOL_SIZE);
+        Test_plain_object::live = 0;
+    }
+
+    void teardown()
+    {
+        Test_pooled_object::mempool_destroy();
+        Objmempool_allocator_base::mempool_destroy_all();
+
+        Objmempool_container::clear();
+    }
+};
+
+TEST(mempool_ptr, make_pooled_objmempool_type__object_from_type_pool)
+{
+    {
+        Objmempool_unique_ptr<Test_pooled_object> obj = make_pooled<Test_pooled_object>(7);
+        LONGS_EQUAL(7, obj->get_id());
+        CHECK(Test_pooled_object::mempool_owns(obj.get()));
+        LONGS_EQUAL(POOL_SIZE - 2, Test_pooled_object::get_mempool_free_obj_count());
+    }
+    LONGS_EQUAL(POOL_SIZE - 1, Test_pooled_object::get_mempool_free_obj_count());
+}
+
+TEST(mempool_ptr, make_pooled_plain_type__object_from_node_pool)
+{
+    {
+        Objmempool_unique_ptr<Test_plain_object> obj = make_pooled<Test_plain_object>(3);
+        LONGS_EQUAL(3, obj->id);
+        LONGS_EQUAL(1, Test_plain_object::live);
+        CHECK(Objmempool_allocator<Test_plain_object>::pool_type::mempool_owns(obj.get()));
+    }
+    LONGS_EQUAL(0, Test_plain_object::live);
+}
+
+TEST(mempool_ptr, make_pooled_shared__shared_until_last_reference_released)
+{
+    Objmempool_shared_ptr<Test_plain_object> first = make_pooled_shared<Test_plain_object>(5);
+    LONGS_EQUAL(1, first.use_count());
+    {
+        Objmempool_shared_ptr<Test_plain_object> second = first;
+        LONGS_EQUAL(2, first.use_count());
+        CHECK(first == second);
+        LONGS_EQUAL(5, second->id);
+    }
+    LONGS_EQUAL(1, first.use_count());
+    LONGS_EQUAL(1, Test_plain_object::live);
+
+    Objmempool_shared_ptr<Test_plain_object> moved(std::move(first));
+    CHECK_FALSE(first);
+    LONGS_EQUAL(1, moved.use_count());
+
+    moved.reset();
+    LONGS_EQUAL(0, Test_plain_object::live);
+}
+
+TEST(mempool_ptr, allocate_pooled_shared__control_block_from_node_pool)
+{
+    {
+        std::shared_ptr<Test_plain_object> first = allocate_pooled_shared<Test_plain_object>(9);
+        std::shared_ptr<Test_plain_object> second = first;
+
+        // The Test_pooled_object pool and the control block node pool.
+        LONGS_EQUAL(2, Objmempool_container::size());
+        LONGS_EQUAL(2, first.use_count());
+        LONGS_EQUAL(9, second->id);
+    }
+    LONGS_EQUAL(0, Test_plain_object::live);
+}
@@ -0,0 +1,158 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * test_objmempool_resource.cpp
+ *
+ */
+
+#include "CppUTest/TestHarness.h"
+
+#include "objmempool_resource.h"
+#include "objmempool_container.h"
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+TEST_GROUP(mempool_resource)
+{
+    void setup()
+    {
+
+    }
+
+    void teardown()
+    {
+        Objmempool_container::clear();
+    }
+};
+
+TEST(mempool_resource, class_index__rounds_up_to_power_of_2_class)
+{
+    LONGS_EQUAL(0, Objmempool_memory_resource::class_index(1));
+    LONGS_EQUAL(0, Objmempool_memory_resource::class_index(16));
+    LONGS_EQUAL(1, Objmempool_memory_resource::class_index(17));
+    LONGS_EQUAL(2, Objmempool_memory_resource::class_index(64));
+    LONGS_EQUAL(3, Objmempool_memory_resource::class_index(65));
+    LONGS_EQUAL(Objmempool_memory_resource::CLASS_COUNT - 1, Objmempool_memory_resource::class_index(4096));
+}
+
+TEST(mempool_resource, create_resource__class_pools_registered_in_container)
+{
+    Objmempool_memory_resource::Options options;
+    options.min_class_size = 64;
+    options.max_class_size = 1024;
+    options.obj_count = 64;
+    Objmempool_memory_resource resource(options);
+
+    LONGS_EQUAL(5, Objmempool_container::size());
+    LONGS_EQUAL(63, Objmempool_size_class<64>::get_mempool_size());
+    LONGS_EQUAL(0, Objmempool_size_class<2048>::get_mempool_size());
+}
+
+TEST(mempool_resource, allocate_small_request__served_from_class_pool)
+{
+    Objmempool_memory_resource resource;
+
+    void * ptr = resource.allocate(100, 8);
+    CHECK(Objmempool_size_class<128>::mempool_owns(ptr));
+    LONGS_EQUAL(Objmempool_memory_resource::CLASS_OBJ_COUNT_DEFAULT - 2, Objmempool_size_class<128>::get_mempool_free_obj_count());
+
+    resource.deallocate(ptr, 100, 8);
+    LONGS_EQUAL(Objmempool_memory_resource::CLASS_OBJ_COUNT_DEFAULT - 1, Objmempool_size_class<128>::get_mempool_free_obj_count());
+}
+
+TEST(mempool_resource, allocate_large_or_overaligned_request__served_from_upstream)
+{
+    Objmempool_memory_resource::Options options;
+    options.max_class_size = 256;
+    Objmempool_memory_resource resource(options, std::pmr::new_delete_resource());
+
+    void * large = resource.allocate(512, 8);
+    CHECK_FALSE(Objmempool_size_class<512>::mempool_owns(large));
+    resource.deallocate(large, 512, 8);
+
+    void * aligned = resource.allocate(32, 64);
+    CHECK_FALSE(Objmempool_size_class<64>::mempool_owns(aligned));
+    LONGS_EQUAL(0, reinterpret_cast<uintptr_t>(aligned) % 64);
+    resource.deallocate(aligned, 32, 64);
+}
+
+TEST(mempool_resource, exhaust_class_pool__served_from_upstream)
+{
+    Objmempool_memory_resource::Options options;
+    options.obj_count = 16;
+    Objmempool_memory_resource resource(options);
+    void * ptrs[16];
+
+    for(int i = 0; i < 16; ++i)
+        ptrs[i] = resource.allocate(16);
+
+    CHECK(Objmempool_size_class<16>::mempool_owns(ptrs[0]));
+    CHECK_FALSE(Objmempool_size_class<16>::mempool_owns(ptrs[15]));
+
+    for(int i = 0; i < 16; ++i)
+        resource.deallocate(ptrs[i], 16);
+    LONGS_EQUAL(15, Objmempool_size_class<16>::get_mempool_free_obj_count());
+}
+
+TEST(mempool_resource, two_resources__class_pools_shared_until_last_destroyed)
+{
+    Objmempool_memory_resource * first = new Objmempool_memory_resource;
+    {
+        Objmempool_memory_resource second;
+        LONGS_EQUAL(Objmempool_memory_resource::CLASS_COUNT, Objmempool_container::size());
+        delete first;
+
+        void * ptr = second.allocate(32);
+        CHECK(Objmempool_size_class<32>::mempool_owns(ptr));
+        second.deallocate(ptr, 32);
+    }
+    LONGS_EQUAL(0, Objmempool_size_class<32>::get_mempool_size());
+}
+
+TEST(mempool_resource, pmr_containers_with_thread_cache__data_integrity)
+{
+    Objmempool_memory_resource resource;
+    resource.mempool_cache_create();
+    {
+        std::pmr::vector<std::pmr::string> fields(&resource);
+        for(int i = 0; i < 200; ++i)
+            fields.emplace_back(std::string(i % 100 + 1, char('a' + i % 26)));
+
+        for(int i = 0; i < 200; ++i)
+        {
+            LONGS_EQUAL(i % 100 + 1, fields[i].size());
+            LONGS_EQUAL('a' + i % 26, fields[i][0]);
+        }
+    }
+    resource.mempool_cache_destroy();
+
+    LONGS_EQUAL(Objmempool_memory_resource::CLASS_OBJ_COUNT_DEFAULT - 1, Objmempool_size_class<32>::get_mempool_free_obj_count());
+}
@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2015, Edward Haas
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of objmempool nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ * test_objmempool_stats.cpp
+ *
+ */
+
+#include "CppUTest/TestHarness.h"
+
+#include "objmempool.h"
+#include "objmempool_container.h"
+
+#include <string.h>
+#include <typeinfo>
+
+class Test_stats_object : public Objmempool<Test_stats_object>
+{
+public:
+    uint64_t data[4];
+};
+
+enum {POOL_SIZE = 128};
+TEST_GROUP(mempool_stats)
+{
+    const Objmempool_stats::Page * reader;
+
+    void setup()
+    {
+        Test_stats_object::mempool_create(POOL_SIZE, Test_stats_object::MEMPOOL_F_STATS);
+
+        char shm[64];
+        Objmempool_stats::shm_name(Test_stats_object::get_mempool_stats_page(), shm, sizeof(shm));
+        reader = Objmempool_stats::open(shm);
+    }
+
+    void teardown()
+    {
+        Objmempool_stats::close(reader);
+        Test_stats_object::mempool_cache_destroy();
+        Test_stats_object::mempool_destroy();
+        Objmempool_container::clear();
+    }
+
+    Objmempool_stats::Thread_slot read_slot(unsigned int idx)
+    {
+        Objmempool_stats::Thread_slot slot;
+        CHECK(Objmempool_stats::slot_read(&reader->threads[idx], slot));
+        return slot;
+    }
+};
+
+TEST(mempool_stats, create_pool__page_published)
+{
+    CHECK(reader != NULL);
+    LONGS_EQUAL(Objmempool_stats::VERSION, reader->version);
+    LONGS_EQUAL(POOL_SIZE - 1, reader->obj_count);
+    LONGS_EQUAL(sizeof(Test_stats_object), reader->obj_size);
+    STRCMP_EQUAL(typeid(Test_stats_object).name(), reader->name);
+    LONGS_EQUAL(0, reader->thread_slots_used);
+}
+
+TEST(mempool_stats, alloc_with_cache__refill_published)
+{
+    Test_stats_object::mempool_cache_create();
+    Test_stats_object * obj = new Test_stats_object;
+
+    LONGS_EQUAL(1, reader->thread_slots_used);
+    Objmempool_stats::Thread_slot slot = read_slot(0);
+    LONGS_EQUAL(1, slot.refills);
+    LONGS_EQUAL(0, slot.flushes);
+    LONGS_EQUAL(Test_stats_object::CACHE_SIZE_DEFAULT, slot.ring_out);
+    LONGS_EQUAL(Test_stats_object::CACHE_SIZE_DEFAULT, slot.cached);
+    CHECK(slot.tid != 0);
+
+    delete obj;
+    Test_stats_object::mempool_cache_flush();
+    slot = read_slot(0);
+    LONGS_EQUAL(1, slot.flushes);
+    LONGS_EQUAL(0, slot.ring_out);
+    LONGS_EQUAL(0, slot.cached);
+}
+
+TEST(mempool_stats, exhausted_pool__failure_published)
+{
+    Test_stats_object * objs[POOL_SIZE - 1];
+    for(int i = 0; i < POOL_SIZE - 1; ++i)
+        objs[i] = new Test_stats_object;
+
+    POINTERS_EQUAL(NULL, Test_stats_object::mempool_alloc());
+    Objmempool_stats::Thread_slot slot = read_slot(0);
+    LONGS_EQUAL(1, slot.alloc_failures);
+    LONGS_EQUAL(POOL_SIZE - 1, slot.ring_out);
+
+    for(int i = 0; i < POOL_SIZE - 1; ++i)
+        delete objs[i];
+}
+
+TEST(mempool_stats, destroy_pool__page_removed)
+{
+    char shm[64];
+    Objmempool_stats::shm_name(Test_stats_object::get_mempool_stats_page(), shm, sizeof(shm));
+    Test_stats_object::mempool_destroy();
+
+    POINTERS_EQUAL(NULL, Test_stats_object::get_mempool_stats_page());
+    POINTERS_EQUAL(NULL, Objmempool_stats::open(shm));
+}